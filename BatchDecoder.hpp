@@ -0,0 +1,302 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+// Needs std::thread (link with Threads::Threads / -pthread).
+#include <inttypes.h>
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Decoder.hpp"
+
+namespace ZCMessagePack
+{
+/// Decodes batches of independent messages on a fixed pool of threads.
+///
+///     BatchDecoder batchDecoder(4);
+///     std::vector<uint32_t> ids(messages.size());
+///     batchDecoder.decode(messages.data(), messages.size(),
+///             [](LargeDecoder f_message) { return f_message["id"].getUint32().get(); },
+///             ids.data());
+///
+/// The messages are split into one range per thread. Threads which finish
+/// early steal half of the remaining range of another thread, so uneven
+/// message sizes do not leave cores idle. Result i always belongs to
+/// message i, independent of which thread decoded it.
+/// The calling thread takes part in decoding, so a pool with one thread
+/// does not start any additional threads.
+class BatchDecoder
+{
+    public:
+        /// @param f_numThreads number of threads decoding a batch (including
+        ///                     the calling thread). 0: one per core.
+        explicit BatchDecoder(unsigned f_numThreads = 0);
+        ~BatchDecoder();
+
+        BatchDecoder(const BatchDecoder &) = delete;
+        BatchDecoder & operator=(const BatchDecoder &) = delete;
+
+        /// Calls f_function(LargeDecoder) for each message and stores the
+        /// returned value in f_out_results[i]. Returns when the whole batch is
+        /// decoded. f_function is called concurrently and must not throw.
+        /// Messages larger than LargeDecoder can address (4 GiB) are not
+        /// decoded: f_function gets an invalid decoder for them.
+        /// Not reentrant: only one thread may call decode() at a time.
+        template<class Function, class Result>
+        void decode(const BinarySpan * f_messages, size_t f_numMessages, Function f_function, Result * f_out_results);
+
+        unsigned getNumThreads() const
+        {
+            return m_numThreads;
+        }
+
+    private:
+        /// Remaining work of one thread: [begin, end) packed into one word
+        /// (begin in the upper 32 bits), so owner and thieves can update it
+        /// with a single compare and swap.
+        struct alignas(64) WorkRange
+        {
+            std::atomic<uint64_t> range{0};
+        };
+
+        static uint64_t packRange(uint64_t f_begin, uint64_t f_end)
+        {
+            return (f_begin << 32) | f_end;
+        }
+
+        /// Type erased batch job: decodes the message with the given index.
+        using Job = void (*)(void * f_context, size_t f_index);
+
+        void runBatch(Job f_job, void * f_context, size_t f_numItems);
+
+        /// Processes own and stolen work until no work is left.
+        void work(unsigned f_worker);
+
+        /// Takes the next index of the worker's own range.
+        bool popOwn(unsigned f_worker, size_t & f_out_index);
+
+        /// Moves half of another worker's remaining range into the own one.
+        bool steal(unsigned f_worker);
+
+        void workerLoop(unsigned f_worker);
+
+        unsigned m_numThreads;
+        std::unique_ptr<WorkRange[]> m_ranges;
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_mutex;
+        std::condition_variable m_batchStarted;
+        std::condition_variable m_batchFinished;
+        uint64_t m_batchNumber = 0;
+        unsigned m_busyWorkers = 0;
+        bool m_stop = false;
+
+        Job m_job = nullptr;
+        void * m_context = nullptr;
+        size_t m_indexOffset = 0;
+};
+
+template<class Function, class Result>
+void BatchDecoder::decode(const BinarySpan * f_messages, size_t f_numMessages, Function f_function, Result * f_out_results)
+{
+    struct Context
+    {
+        const BinarySpan * messages;
+        Function & function;
+        Result * results;
+    };
+    Context context{f_messages, f_function, f_out_results};
+    Job job = [](void * f_context, size_t f_index) {
+        Context & context = *static_cast<Context *>(f_context);
+        const BinarySpan & message = context.messages[f_index];
+        if(message.size > std::numeric_limits<uint32_t>::max())
+        {
+            context.results[f_index] = context.function(LargeDecoder());
+            return;
+        }
+        context.results[f_index] = context.function(LargeDecoder(message.data, static_cast<uint32_t>(message.size)));
+    };
+    runBatch(job, &context, f_numMessages);
+}
+
+inline BatchDecoder::BatchDecoder(unsigned f_numThreads) :
+    m_numThreads(f_numThreads)
+{
+    if(m_numThreads == 0)
+    {
+        m_numThreads = std::thread::hardware_concurrency();
+    }
+    if(m_numThreads == 0)
+    {
+        m_numThreads = 1;
+    }
+    m_ranges.reset(new WorkRange[m_numThreads]);
+    // worker 0 is the thread calling decode()
+    for(unsigned worker = 1; worker < m_numThreads; worker++)
+    {
+        m_threads.emplace_back(&BatchDecoder::workerLoop, this, worker);
+    }
+}
+
+inline BatchDecoder::~BatchDecoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_batchStarted.notify_all();
+    for(std::thread & thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+inline void BatchDecoder::runBatch(Job f_job, void * f_context, size_t f_numItems)
+{
+    if(m_numThreads == 1 or f_numItems <= 1)
+    {
+        for(size_t index = 0; index < f_numItems; index++)
+        {
+            f_job(f_context, index);
+        }
+        return;
+    }
+
+    // ranges hold 32 bit indices, bigger batches are processed in parts
+    const size_t maxPartSize = UINT32_MAX;
+    for(size_t partStart = 0; partStart < f_numItems; partStart += maxPartSize)
+    {
+        uint64_t partSize = f_numItems - partStart < maxPartSize ? f_numItems - partStart : maxPartSize;
+        for(unsigned worker = 0; worker < m_numThreads; worker++)
+        {
+            uint64_t begin = partSize * worker / m_numThreads;
+            uint64_t end = partSize * (worker + 1) / m_numThreads;
+            m_ranges[worker].range.store(packRange(begin, end), std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = f_job;
+            m_context = f_context;
+            m_indexOffset = partStart;
+            m_busyWorkers = m_numThreads - 1;
+            m_batchNumber++;
+        }
+        m_batchStarted.notify_all();
+
+        work(0);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_batchFinished.wait(lock, [this]() { return m_busyWorkers == 0; });
+    }
+}
+
+inline void BatchDecoder::work(unsigned f_worker)
+{
+    size_t index;
+    while(true)
+    {
+        while(popOwn(f_worker, index))
+        {
+            m_job(m_context, m_indexOffset + index);
+        }
+        if(not steal(f_worker))
+        {
+            return;
+        }
+    }
+}
+
+inline bool BatchDecoder::popOwn(unsigned f_worker, size_t & f_out_index)
+{
+    std::atomic<uint64_t> & range = m_ranges[f_worker].range;
+    uint64_t current = range.load(std::memory_order_acquire);
+    while(true)
+    {
+        uint64_t begin = current >> 32;
+        uint64_t end = current & 0xffffffff;
+        if(begin >= end)
+        {
+            return false;
+        }
+        if(range.compare_exchange_weak(current, packRange(begin + 1, end), std::memory_order_acq_rel))
+        {
+            f_out_index = begin;
+            return true;
+        }
+    }
+}
+
+inline bool BatchDecoder::steal(unsigned f_worker)
+{
+    for(unsigned offset = 1; offset < m_numThreads; offset++)
+    {
+        std::atomic<uint64_t> & victim = m_ranges[(f_worker + offset) % m_numThreads].range;
+        uint64_t current = victim.load(std::memory_order_acquire);
+        while(true)
+        {
+            uint64_t begin = current >> 32;
+            uint64_t end = current & 0xffffffff;
+            if(begin >= end)
+            {
+                break;
+            }
+            // victim keeps [begin, middle), thief takes [middle, end)
+            uint64_t middle = begin + (end - begin) / 2;
+            if(victim.compare_exchange_weak(current, packRange(begin, middle), std::memory_order_acq_rel))
+            {
+                // own range is empty, nobody else changes it
+                m_ranges[f_worker].range.store(packRange(middle, end), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+inline void BatchDecoder::workerLoop(unsigned f_worker)
+{
+    uint64_t lastBatch = 0;
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_batchStarted.wait(lock, [&]() { return m_stop or m_batchNumber != lastBatch; });
+            if(m_stop)
+            {
+                return;
+            }
+            lastBatch = m_batchNumber;
+        }
+
+        work(f_worker);
+
+        bool lastWorker;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busyWorkers--;
+            lastWorker = m_busyWorkers == 0;
+        }
+        if(lastWorker)
+        {
+            m_batchFinished.notify_one();
+        }
+    }
+}
+
+}
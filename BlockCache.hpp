@@ -0,0 +1,189 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <inttypes.h>
+#include <stddef.h>
+#include <cstring>
+
+namespace ZCMessagePack
+{
+/// Block cache in front of a slow RawMessageReader (file, flash, network, ...).
+///
+/// GenericDecoder reads headers byte by byte. Backed by a BlockCache, every
+/// read of the underlying reader fetches a whole aligned block of BlockSize
+/// bytes instead, and following reads from the same block are served from
+/// memory. The cache is direct mapped: block n is kept in slot n % NumBlocks.
+///
+/// Decoders copy their reader, so the cache itself is not used as reader.
+/// Instead getReader() returns a lightweight handle pointing to the cache:
+///
+///     BlockCache<FileReader, 256> cache(FileReader(file), messageSize);
+///     GenericDecoder<BlockCache<FileReader, 256>::Reader, uint32_t> decoder(cache.getReader(), messageSize);
+///
+/// The cache must outlive all decoders using it. It is not thread safe.
+template<class RawMessageReader, size_t BlockSize = 64, size_t NumBlocks = 1, class PositionType = uint32_t>
+class BlockCache
+{
+    static_assert(BlockSize > 0, "BlockSize must not be 0");
+    static_assert(NumBlocks > 0, "NumBlocks must not be 0");
+
+    public:
+        /// Handle used as RawMessageReader of a GenericDecoder.
+        class Reader
+        {
+            public:
+                Reader() = default;
+                Reader(BlockCache * f_borrow_cache) : m_cache(f_borrow_cache) {}
+
+                template<class P>
+                void read(P f_offset, P f_size, uint8_t * f_out_buffer) const
+                {
+                    m_cache->read(f_offset, f_size, f_out_buffer);
+                }
+            private:
+                BlockCache * m_cache = nullptr;
+        };
+
+        /// @param f_messageSize size of the message accessible through
+        ///                      f_raw_message_reader. Blocks at the end of the
+        ///                      message are truncated, so the underlying reader
+        ///                      is never asked for bytes behind the message.
+        BlockCache(RawMessageReader f_raw_message_reader, PositionType f_messageSize) :
+            m_raw_message_reader(f_raw_message_reader),
+            m_messageSize(f_messageSize)
+        {
+            invalidate();
+        }
+
+        /// Not copyable, Reader handles refer to the cache by address.
+        BlockCache(const BlockCache &) = delete;
+        BlockCache & operator=(const BlockCache &) = delete;
+
+        Reader getReader()
+        {
+            return Reader(this);
+        }
+
+        /// Reads f_size bytes starting at f_offset.
+        /// Requests of at least BlockSize bytes bypass the cache and are
+        /// forwarded to the underlying reader in one piece (counted as miss).
+        /// Bytes behind the message are not requested from the underlying
+        /// reader, they are filled with 0.
+        template<class P>
+        void read(P f_offset, P f_size, uint8_t * f_out_buffer);
+
+        /// Drops all cached blocks, e.g. after the underlying data changed.
+        void invalidate()
+        {
+            for(size_t slot = 0; slot < NumBlocks; slot++)
+            {
+                m_blockNumbers[slot] = noBlock;
+            }
+        }
+
+        /// Number of reads (or parts of reads) served from the cache.
+        uint64_t getHits() const
+        {
+            return m_hits;
+        }
+
+        /// Number of reads issued to the underlying reader.
+        uint64_t getMisses() const
+        {
+            return m_misses;
+        }
+
+        void resetCounters()
+        {
+            m_hits = 0;
+            m_misses = 0;
+        }
+
+    private:
+        static constexpr uint64_t noBlock = ~static_cast<uint64_t>(0);
+
+        /// Returns the cached data of the given block, fetches it on a miss.
+        const uint8_t * getBlock(uint64_t f_blockNumber);
+
+        RawMessageReader m_raw_message_reader;
+        PositionType m_messageSize;
+        uint64_t m_blockNumbers[NumBlocks];
+        uint8_t m_blocks[NumBlocks][BlockSize];
+        uint64_t m_hits = 0;
+        uint64_t m_misses = 0;
+};
+
+template<class T, size_t B, size_t N, class P>
+template<class ReadPositionType>
+void BlockCache<T, B, N, P>::read(ReadPositionType f_offset, ReadPositionType f_size, uint8_t * f_out_buffer)
+{
+    uint64_t size = f_size;
+    if(static_cast<uint64_t>(f_offset) + size > m_messageSize)
+    {
+        uint64_t sizeInMessage = f_offset < m_messageSize ? m_messageSize - f_offset : 0;
+        std::memset(f_out_buffer + sizeInMessage, 0, size - sizeInMessage);
+        size = sizeInMessage;
+    }
+    if(size == 0)
+    {
+        return;
+    }
+
+    if(size >= B)
+    {
+        m_misses++;
+        m_raw_message_reader.read(static_cast<P>(f_offset), static_cast<P>(size), f_out_buffer);
+        return;
+    }
+
+    // small reads span at most two blocks
+    uint64_t offset = f_offset;
+    uint64_t remaining = size;
+    while(remaining > 0)
+    {
+        uint64_t blockNumber = offset / B;
+        uint64_t offsetInBlock = offset % B;
+        uint64_t chunkSize = B - offsetInBlock < remaining ? B - offsetInBlock : remaining;
+        std::memcpy(f_out_buffer, getBlock(blockNumber) + offsetInBlock, chunkSize);
+        f_out_buffer += chunkSize;
+        offset += chunkSize;
+        remaining -= chunkSize;
+    }
+}
+
+template<class T, size_t B, size_t N, class P>
+const uint8_t * BlockCache<T, B, N, P>::getBlock(uint64_t f_blockNumber)
+{
+    size_t slot = f_blockNumber % N;
+    if(m_blockNumbers[slot] == f_blockNumber)
+    {
+        m_hits++;
+        return m_blocks[slot];
+    }
+
+    m_misses++;
+    uint64_t blockStart = f_blockNumber * B;
+    uint64_t blockSize = B;
+    if(blockStart + blockSize > m_messageSize)
+    {
+        // last block of the message, read() ensures it starts within the message
+        blockSize = m_messageSize - blockStart;
+    }
+    m_raw_message_reader.read(static_cast<P>(blockStart), static_cast<P>(blockSize), m_blocks[slot]);
+    m_blockNumbers[slot] = f_blockNumber;
+    return m_blocks[slot];
+}
+
+}
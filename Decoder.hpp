@@ -15,7 +15,15 @@
 #pragma once
 #include <inttypes.h>
 #include <cstring>
+#include <iterator>
+#include <limits>
 #include <string.h>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace ZCMessagePack
 {
@@ -23,58 +31,521 @@ template<class T>
 class Maybe
 {
     public:
-        Maybe() = default;
-        Maybe(T f_value) : m_valid(true), m_value(f_value) {}
+        constexpr Maybe() = default;
+        constexpr Maybe(T f_value) : m_valid(true), m_value(f_value) {}
 
         /// undefined behavior if invalid
-        T get()
+        constexpr T get()
         {
             return m_value;
         }
-        bool isValid()
+        constexpr bool isValid()
         {
             return m_valid;
         }
     private:
     bool m_valid = false;
-    T m_value;
+    T m_value = T();
 };
 
 
 class MemoryReader
 {
     public:
-    MemoryReader(const uint8_t * f_messageBuffer) :
+    constexpr MemoryReader() = default;
+
+    constexpr MemoryReader(const uint8_t * f_messageBuffer) :
         buffer(f_messageBuffer)
     {
     }
 
-    void read(uint8_t f_offset, uint8_t f_size, uint8_t * f_out_buffer ) const
+    template<class PositionType>
+    void read(PositionType f_offset, PositionType f_size, uint8_t * f_out_buffer ) const
     {
         std::memcpy(f_out_buffer, buffer + f_offset, f_size);
     }
+
+    /// Direct access to the underlying buffer (see HasContiguousData)
+    constexpr const uint8_t * data() const
+    {
+        return buffer;
+    }
     private:
-    const uint8_t * buffer;
+    const uint8_t * buffer = nullptr;
+};
+
+/// Non-owning view of binary data inside a message buffer.
+struct BinarySpan
+{
+    const uint8_t * data = nullptr;
+    size_t size = 0;
 };
 
+/// Loads a big endian number of sizeof...(Index) bytes. Written as a single
+/// expression, so compilers can emit one load + byte swap.
+template<size_t... Index>
+constexpr uint64_t loadBigEndian(const uint8_t * f_data, std::index_sequence<Index...>)
+{
+    return ((static_cast<uint64_t>(f_data[Index]) << (8 * (sizeof...(Index) - 1 - Index))) | ... | 0);
+}
+
+/// Loads an unaligned native endian word (compiles to a single load).
+template<class Word>
+inline Word loadWord(const void * f_data)
+{
+    Word word;
+    std::memcpy(&word, f_data, sizeof(word));
+    return word;
+}
+
+/// Compares f_length bytes of f_stored against f_string.
+/// Short keys are compared with at most two overlapping word loads instead of
+/// calling memcmp, longer ones 16 (SSE2) or 8 bytes at a time. Never reads
+/// outside of both buffers.
+inline bool equalBytes(const uint8_t * f_stored, const char * f_string, size_t f_length)
+{
+    if(f_length < 4)
+    {
+        if(f_length == 0)
+        {
+            return true;
+        }
+        // first, middle and last byte cover all lengths up to 3
+        return
+            f_stored[0] == static_cast<uint8_t>(f_string[0])
+            and f_stored[f_length / 2] == static_cast<uint8_t>(f_string[f_length / 2])
+            and f_stored[f_length - 1] == static_cast<uint8_t>(f_string[f_length - 1]);
+    }
+    if(f_length <= 8)
+    {
+        return
+            ((loadWord<uint32_t>(f_stored) ^ loadWord<uint32_t>(f_string))
+             | (loadWord<uint32_t>(f_stored + f_length - 4) ^ loadWord<uint32_t>(f_string + f_length - 4))) == 0;
+    }
+    if(f_length <= 16)
+    {
+        return
+            ((loadWord<uint64_t>(f_stored) ^ loadWord<uint64_t>(f_string))
+             | (loadWord<uint64_t>(f_stored + f_length - 8) ^ loadWord<uint64_t>(f_string + f_length - 8))) == 0;
+    }
+#if defined(__SSE2__)
+    auto equal16 = [&](size_t f_offset) {
+        __m128i stored = _mm_loadu_si128(reinterpret_cast<const __m128i *>(f_stored + f_offset));
+        __m128i string = _mm_loadu_si128(reinterpret_cast<const __m128i *>(f_string + f_offset));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(stored, string)) == 0xffff;
+    };
+    for(size_t offset = 0; offset + 16 < f_length; offset += 16)
+    {
+        if(not equal16(offset))
+        {
+            return false;
+        }
+    }
+    // last block overlaps the previous one if the length is not a multiple of 16
+    return equal16(f_length - 16);
+#else
+    for(size_t offset = 0; offset + 8 < f_length; offset += 8)
+    {
+        if(loadWord<uint64_t>(f_stored + offset) != loadWord<uint64_t>(f_string + offset))
+        {
+            return false;
+        }
+    }
+    return loadWord<uint64_t>(f_stored + f_length - 8) == loadWord<uint64_t>(f_string + f_length - 8);
+#endif
+}
+
+/// Loads 8 bytes, the first one ending up in the least significant byte
+/// (see Key::getPrefix()).
+inline uint64_t loadLittleEndianWord(const uint8_t * f_data)
+{
+    uint64_t word = loadWord<uint64_t>(f_data);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+/// Map key with precomputed length and prefix, for repeated lookups:
+///   constexpr Key idKey("id");
+///   decoder[idKey].getUint32();
+/// Stored keys of different length are rejected by a single integer compare,
+/// keys of equal length by a second one, comparing their first (up to) 8
+/// bytes. Only keys sharing the prefix are compared further.
+/// The key string is not copied and must outlive the Key.
+class Key
+{
+    public:
+        /// @param f_key null terminated key
+        constexpr explicit Key(const char * f_key) :
+            Key(f_key, std::char_traits<char>::length(f_key))
+        {
+        }
+
+        /// @param f_key key of given length, does not need to be null terminated
+        constexpr Key(const char * f_key, size_t f_length) :
+            m_key(f_key),
+            m_length(f_length)
+        {
+            size_t prefixLength = f_length < 8 ? f_length : 8;
+            for(size_t i = 0; i < prefixLength; i++)
+            {
+                m_prefix |= static_cast<uint64_t>(static_cast<uint8_t>(f_key[i])) << (8 * i);
+            }
+            m_prefixMask = prefixLength == 8 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << (8 * prefixLength)) - 1;
+        }
+
+        constexpr const char * data() const
+        {
+            return m_key;
+        }
+
+        constexpr size_t size() const
+        {
+            return m_length;
+        }
+
+        /// First min(size(), 8) bytes, byte i stored in bits [8 * i, 8 * i + 8).
+        constexpr uint64_t getPrefix() const
+        {
+            return m_prefix;
+        }
+
+        /// Selects the bytes of getPrefix() belonging to the key.
+        constexpr uint64_t getPrefixMask() const
+        {
+            return m_prefixMask;
+        }
+
+    private:
+        const char * m_key;
+        size_t m_length;
+        uint64_t m_prefix = 0;
+        uint64_t m_prefixMask = 0;
+};
+
+/// True while the calling constexpr function is evaluated at compile time.
+/// Lets the decoder fall back to plain loops where it otherwise calls
+/// library functions (memcmp, ...), which are not usable in constant
+/// expressions. Always false if the compiler cannot tell.
+constexpr bool isConstantEvaluated()
+{
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+    return __builtin_is_constant_evaluated();
+#else
+    return false;
+#endif
+#else
+    return false;
+#endif
+}
+
+/// Detects if a RawMessageReader keeps the whole message in contiguous memory.
+/// Readers providing a `const uint8_t * data() const` function are accessed
+/// directly by GenericDecoder instead of going through read().
+template<class RawMessageReader, class = void>
+struct HasContiguousData : std::false_type {};
+
 template<class RawMessageReader>
+struct HasContiguousData<RawMessageReader, std::void_t<decltype(std::declval<const RawMessageReader &>().data())>> :
+    std::is_convertible<decltype(std::declval<const RawMessageReader &>().data()), const uint8_t *> {};
+
+/// Decoded header of a MessagePack element.
+struct HeaderInfo
+{
+    enum HeaderType
+    {
+        InvalidHeader,
+        Map,
+        Array,
+        Int,
+        Uint,
+        True,
+        False,
+        String,
+        Nil,
+        Float
+    };
+    uint8_t headerSize = 0;
+    uint32_t numPayloadElements = 0;
+    HeaderType headerType = InvalidHeader;
+};
+
+/// Header information which is fully determined by the first (type) byte.
+struct TypeCodeInfo
+{
+    /// HeaderInfo::HeaderType, stored as a byte to keep the table small.
+    uint8_t headerType;
+    /// Size of the header. If bigger than 1, the type byte is followed by
+    /// (headerSize - 1) bytes holding numPayloadElements (big endian).
+    uint8_t headerSize;
+    /// Number of payload elements, if not stored after the type byte.
+    uint8_t numPayloadElements;
+};
+
+/// Lookup table from type byte to TypeCodeInfo, generated at compile time.
+struct TypeCodeTable
+{
+    TypeCodeInfo entries[256];
+};
+
+constexpr TypeCodeTable makeTypeCodeTable()
+{
+    TypeCodeTable table{};
+    for(int typeCode = 0; typeCode < 256; typeCode++)
+    {
+        TypeCodeInfo & info = table.entries[typeCode];
+        info = TypeCodeInfo{HeaderInfo::InvalidHeader, 1, 0};
+
+        // compressed headers:
+        if((typeCode & 0x80) == 0)
+        {
+            info.headerType = HeaderInfo::Uint;
+        }
+        else if((typeCode & 0xe0) == 0xe0)
+        {
+            info.headerType = HeaderInfo::Int;
+        }
+        else if((typeCode & 0xe0) == 0xa0)
+        {
+            info.headerType = HeaderInfo::String;
+            info.numPayloadElements = typeCode & 0x1f;
+        }
+        else if((typeCode & 0xf0) == 0x90)
+        {
+            info.headerType = HeaderInfo::Array;
+            info.numPayloadElements = typeCode & 0x0f;
+        }
+        else if((typeCode & 0xf0) == 0x80)
+        {
+            info.headerType = HeaderInfo::Map;
+            info.numPayloadElements = typeCode & 0x0f;
+        }
+    }
+
+    // full headers:
+    table.entries[0xc0] = TypeCodeInfo{HeaderInfo::Nil, 1, 0};
+    table.entries[0xc2] = TypeCodeInfo{HeaderInfo::False, 1, 0};
+    table.entries[0xc3] = TypeCodeInfo{HeaderInfo::True, 1, 0};
+
+    table.entries[0xcc] = TypeCodeInfo{HeaderInfo::Uint, 1, 1};
+    table.entries[0xcd] = TypeCodeInfo{HeaderInfo::Uint, 1, 2};
+    table.entries[0xce] = TypeCodeInfo{HeaderInfo::Uint, 1, 4};
+    table.entries[0xcf] = TypeCodeInfo{HeaderInfo::Uint, 1, 8};
+
+    table.entries[0xd0] = TypeCodeInfo{HeaderInfo::Int, 1, 1};
+    table.entries[0xd1] = TypeCodeInfo{HeaderInfo::Int, 1, 2};
+    table.entries[0xd2] = TypeCodeInfo{HeaderInfo::Int, 1, 4};
+    table.entries[0xd3] = TypeCodeInfo{HeaderInfo::Int, 1, 8};
+
+    table.entries[0xca] = TypeCodeInfo{HeaderInfo::Float, 1, 4};
+    table.entries[0xcb] = TypeCodeInfo{HeaderInfo::Float, 1, 8};
+
+    table.entries[0xd9] = TypeCodeInfo{HeaderInfo::String, 2, 0};
+    table.entries[0xda] = TypeCodeInfo{HeaderInfo::String, 3, 0};
+    table.entries[0xdb] = TypeCodeInfo{HeaderInfo::String, 5, 0};
+    table.entries[0xc4] = TypeCodeInfo{HeaderInfo::String, 2, 0};
+    table.entries[0xc5] = TypeCodeInfo{HeaderInfo::String, 3, 0};
+    table.entries[0xc6] = TypeCodeInfo{HeaderInfo::String, 5, 0};
+    table.entries[0xdc] = TypeCodeInfo{HeaderInfo::Array, 3, 0};
+    table.entries[0xdd] = TypeCodeInfo{HeaderInfo::Array, 5, 0};
+    table.entries[0xde] = TypeCodeInfo{HeaderInfo::Map, 3, 0};
+    table.entries[0xdf] = TypeCodeInfo{HeaderInfo::Map, 5, 0};
+    return table;
+}
+
+inline constexpr TypeCodeTable typeCodeTable = makeTypeCodeTable();
+
+/// Handler for GenericDecoder::visit() ignoring all elements.
+/// Derive from it and hide the functions of interest.
+struct VisitorBase
+{
+    bool onMapBegin(uint32_t) { return true; }
+    bool onMapEnd() { return true; }
+    bool onArrayBegin(uint32_t) { return true; }
+    bool onArrayEnd() { return true; }
+    bool onKey(std::string_view) { return true; }
+    bool onNil() { return true; }
+    bool onBool(bool) { return true; }
+    bool onUint(uint64_t) { return true; }
+    bool onInt(int64_t) { return true; }
+    bool onFloat(float) { return true; }
+    bool onDouble(double) { return true; }
+    bool onString(std::string_view) { return true; }
+    bool onBinary(BinarySpan) { return true; }
+};
+
+/// One step of a Path: either a map key or an array index.
+struct PathStep
+{
+    /// Points into the path string, not null terminated.
+    const char * key = nullptr;
+    size_t keyLength = 0;
+    uint32_t index = 0;
+    bool isIndex = false;
+};
+
+/// Path expression like "sensors[3].temp", parsed at compile time if
+/// created as constexpr (see makePath()).
+/// Syntax: map keys are separated by '.', array indices are written as [n].
+/// Keys must not be empty and cannot contain '.' or '['.
+/// The empty path refers to the current element.
+/// MaxSteps is an upper bound for the number of steps (size of the path
+/// string literal).
+template<size_t MaxSteps>
+class Path
+{
+    public:
+        constexpr Path(const char * f_path);
+
+        /// False if the path string has a syntax error.
+        constexpr bool isValid() const
+        {
+            return m_valid;
+        }
+
+        constexpr size_t getNumSteps() const
+        {
+            return m_numSteps;
+        }
+
+        constexpr const PathStep & getStep(size_t f_step) const
+        {
+            return m_steps[f_step];
+        }
+
+    private:
+        PathStep m_steps[MaxSteps];
+        size_t m_numSteps = 0;
+        bool m_valid = true;
+};
+
+/// Parses a path string literal:
+///   constexpr auto tempPath = makePath("sensors[3].temp");
+///   static_assert(tempPath.isValid());
+///   auto temp = decoder[tempPath].getInt16();
+template<size_t Size>
+constexpr Path<Size> makePath(const char (&f_path)[Size])
+{
+    return Path<Size>(f_path);
+}
+
+/// Counters collected by CountingInstrumentation.
+struct DecoderStats
+{
+    /// Number of headers decoded (each element touched, also while skipping).
+    uint64_t decodeHeaderCalls = 0;
+    /// Number of message bytes read through the RawMessageReader.
+    uint64_t bytesRead = 0;
+    /// Number of elements skipped by seekNextElement().
+    uint64_t seekNextElementCalls = 0;
+    /// Number of string payloads compared against a key/string.
+    uint64_t keyComparisons = 0;
+};
+
+/// Default instrumentation policy of GenericDecoder.
+/// All hooks are empty and compile to nothing.
+struct NoInstrumentation
+{
+    static constexpr void onDecodeHeader() {}
+    static constexpr void onBytesRead(size_t) {}
+    static constexpr void onSeekNextElement() {}
+    static constexpr void onKeyComparison() {}
+};
+
+/// Instrumentation policy counting hot path operations of GenericDecoder,
+/// e.g. to find out why a lookup is slow:
+///
+///     using CountingDecoder = GenericDecoder<MemoryReader, uint8_t, CountingInstrumentation>;
+///     CountingInstrumentation::resetStats();
+///     decoder["sensors"]["temp"].getInt16();
+///     DecoderStats stats = CountingInstrumentation::getStats();
+///
+/// Counters are per thread and shared by all counting decoders of the thread
+/// (operator[] and accessArray() return copies of the decoder).
+/// Counting decoders cannot be used in constant expressions.
+struct CountingInstrumentation
+{
+    static DecoderStats getStats()
+    {
+        return stats();
+    }
+
+    static void resetStats()
+    {
+        stats() = DecoderStats();
+    }
+
+    static void onDecodeHeader()
+    {
+        stats().decodeHeaderCalls++;
+    }
+
+    static void onBytesRead(size_t f_numBytes)
+    {
+        stats().bytesRead += f_numBytes;
+    }
+
+    static void onSeekNextElement()
+    {
+        stats().seekNextElementCalls++;
+    }
+
+    static void onKeyComparison()
+    {
+        stats().keyComparisons++;
+    }
+
+    private:
+    static DecoderStats & stats()
+    {
+        thread_local DecoderStats threadStats;
+        return threadStats;
+    }
+};
+
+template<class RawMessageReader, class PositionType>
+class GenericIndexedDecoder;
+
+template<class RawMessageReader, class PositionType>
+class GenericMessageSplitter;
+
+/// PositionType is the unsigned integer type used for offsets and sizes within
+/// the message. It limits the maximum message size (uint8_t: 255 bytes).
+/// Use a wider type (e.g. uint32_t or size_t) to decode bigger messages.
+/// Instrumentation is notified about hot path operations, see
+/// CountingInstrumentation. The default NoInstrumentation adds no overhead.
+template<class RawMessageReader, class PositionType = uint8_t, class Instrumentation = NoInstrumentation>
 class GenericDecoder
 {
 
     public:
         // Constructs a new decoder that reads message data from the given message
         // reader. The message reader must provide a read function with the following signature:
-        // void read(uint8_t f_offset, uint8_t f_size, uint8_t * f_out_buffer) const
+        // void read(PositionType f_offset, PositionType f_size, uint8_t * f_out_buffer) const
         // where f_offset is the offset in the message buffer, f_size is the number of bytes to read, f_out_buffer is the buffer to write the read data to.
-        GenericDecoder(RawMessageReader f_raw_message_reader, uint8_t f_messageSize) :
+        // If the reader additionally provides `const uint8_t * data() const`, the message is accessed directly through that pointer.
+        constexpr GenericDecoder(RawMessageReader f_raw_message_reader, PositionType f_messageSize) :
             m_raw_message_reader(f_raw_message_reader),
             m_messageSize(f_messageSize)
         {
         }
 
+        /// Constructs an invalid decoder, which can be assigned later on
+        /// (e.g. arrays of decoders for getMapValues()).
+        /// Requires RawMessageReader to be default constructible.
+        constexpr GenericDecoder() :
+            m_messageSize(0),
+            m_validSeek(false)
+        {
+        }
+
         // Constructs a non-Generic Decoder using MemoryReader as the RawMessageReader.
         template<typename U = RawMessageReader>
-        GenericDecoder(const uint8_t * f_borrow_messageBuffer, uint8_t f_messageSize, typename std::enable_if<std::is_same<U, MemoryReader>::value>::type* = 0) :
+        constexpr GenericDecoder(const uint8_t * f_borrow_messageBuffer, PositionType f_messageSize, typename std::enable_if<std::is_same<U, MemoryReader>::value>::type* = 0) :
             m_raw_message_reader(MemoryReader(f_borrow_messageBuffer)), m_messageSize(f_messageSize)
         {
         }
@@ -83,27 +554,57 @@ class GenericDecoder
         
         /// Returns a new decoder which is seeked to the map value, matching given key.
         /// Returned GenericDecoder will refer to the map value (not the key).
-        GenericDecoder operator[](const char * f_mapKey) const;
+        constexpr GenericDecoder operator[](const char * f_mapKey) const;
+
+        /// Same as operator[](const char *), using a precomputed Key.
+        constexpr GenericDecoder operator[](const Key & f_mapKey) const;
+
+        /// Returns a new decoder which is seeked to the element addressed by
+        /// f_path, relative to the current position. All steps are executed by
+        /// a single decoder, key lengths are taken from the path.
+        /// If the path is invalid or not found, the decoder will become invalid.
+        template<size_t MaxSteps>
+        constexpr GenericDecoder operator[](const Path<MaxSteps> & f_path) const;
 
         /// Returns a new decoder which is seeked to the given array index.
         /// If f_index is out of range, the decoder will become invalid.
         /// NOTE: cannot overload operator[] for array access as implicit conversion is performed from int literal to char * whcih makes it ambiguous
-        GenericDecoder accessArray(uint8_t f_index) const;
+        constexpr GenericDecoder accessArray(uint32_t f_index) const;
 
         /// Resets decoder position to the message root element.
         /// This will recover from an invalid decoder state.
-        void seekReset()
+        constexpr void seekReset()
         {
             m_position = 0;
             m_validSeek = true;
         }
 
         /// Set decoder position to map element with given key.
-        void seekElementByKey(const char * f_key);
+        constexpr void seekElementByKey(const char * f_key);
+
+        /// Same as seekElementByKey(const char *), for keys of known length
+        /// (f_key does not need to be null terminated).
+        constexpr void seekElementByKey(const char * f_key, size_t f_keyLength);
+
+        /// Same as seekElementByKey(const char *), using a precomputed Key.
+        constexpr void seekElementByKey(const Key & f_key);
+
+        /// Looks up several map keys with a single pass over the map.
+        /// The map is only traversed until all keys have been found.
+        /// @param f_keys array of f_numKeys null terminated keys.
+        /// @param f_out_values user-allocated array of f_numKeys decoders.
+        ///                     f_out_values[i] will refer to the value of
+        ///                     f_keys[i], or be invalid if the key was not found.
+        /// @returns number of keys found
+        uint8_t getMapValues(const char * const * f_keys, GenericDecoder * f_out_values, uint8_t f_numKeys) const;
+
+        /// Set decoder position to the element addressed by f_path (see operator[]).
+        template<size_t MaxSteps>
+        constexpr void seekPath(const Path<MaxSteps> & f_path);
 
         /// Set decoder position to array element with given index.
         /// If f_index is out of range, the decoder will become invalid.
-        void seekElementByIndex(uint8_t f_index);
+        constexpr void seekElementByIndex(uint32_t f_index);
 
         /// Retrive both the Key and the Value of a map entry at given index.
         /// @param f_index given index of the map entry. If out of range, an
@@ -114,7 +615,186 @@ class GenericDecoder
         ///                  it is always null terminated.
         /// @param f_maxSize Maximum number of bytes to write to f_out_key
         ///                  (including null termination)
-        GenericDecoder getMapEntryByIndex(uint8_t f_index, char * f_out_key, uint8_t f_maxSize);
+        GenericDecoder getMapEntryByIndex(uint32_t f_index, char * f_out_key, PositionType f_maxSize);
+
+        /// Key and Value of a map entry, as returned by MapIterator.
+        struct MapEntry
+        {
+            GenericDecoder key;
+            GenericDecoder value;
+        };
+
+        /// Forward iterator over the elements of an array.
+        /// Each step skips exactly one element, so iterating the whole array
+        /// is linear in its size (unlike calling accessArray() for each index).
+        class ArrayIterator
+        {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = GenericDecoder;
+                using difference_type = std::ptrdiff_t;
+                using pointer = GenericDecoder *;
+                using reference = GenericDecoder &;
+
+                ArrayIterator(const GenericDecoder & f_element, uint32_t f_remaining) :
+                    m_element(f_element), m_remaining(f_remaining)
+                {
+                }
+                GenericDecoder & operator*()
+                {
+                    return m_element;
+                }
+                GenericDecoder * operator->()
+                {
+                    return &m_element;
+                }
+                ArrayIterator & operator++()
+                {
+                    m_remaining--;
+                    if(m_remaining > 0)
+                    {
+                        m_element.seekNextElement();
+                        if(not m_element.m_validSeek)
+                        {
+                            m_remaining = 0;
+                        }
+                    }
+                    return *this;
+                }
+                ArrayIterator operator++(int)
+                {
+                    ArrayIterator previous = *this;
+                    ++*this;
+                    return previous;
+                }
+                bool operator==(const ArrayIterator & f_other) const
+                {
+                    return m_remaining == f_other.m_remaining;
+                }
+                bool operator!=(const ArrayIterator & f_other) const
+                {
+                    return m_remaining != f_other.m_remaining;
+                }
+            private:
+                GenericDecoder m_element;
+                uint32_t m_remaining;
+        };
+
+        /// Forward iterator over the entries of a map.
+        class MapIterator
+        {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = MapEntry;
+                using difference_type = std::ptrdiff_t;
+                using pointer = MapEntry *;
+                using reference = MapEntry &;
+
+                MapIterator(const GenericDecoder & f_key, uint32_t f_remaining) :
+                    m_entry{f_key, f_key}, m_remaining(f_remaining)
+                {
+                    seekValue();
+                }
+                MapEntry & operator*()
+                {
+                    return m_entry;
+                }
+                MapEntry * operator->()
+                {
+                    return &m_entry;
+                }
+                MapIterator & operator++()
+                {
+                    m_remaining--;
+                    if(m_remaining > 0)
+                    {
+                        m_entry.key = m_entry.value;
+                        m_entry.key.seekNextElement();
+                        m_entry.value = m_entry.key;
+                        seekValue();
+                    }
+                    return *this;
+                }
+                MapIterator operator++(int)
+                {
+                    MapIterator previous = *this;
+                    ++*this;
+                    return previous;
+                }
+                bool operator==(const MapIterator & f_other) const
+                {
+                    return m_remaining == f_other.m_remaining;
+                }
+                bool operator!=(const MapIterator & f_other) const
+                {
+                    return m_remaining != f_other.m_remaining;
+                }
+            private:
+                void seekValue()
+                {
+                    if(m_remaining == 0)
+                    {
+                        return;
+                    }
+                    m_entry.value.seekNextElement();
+                    if(not m_entry.key.m_validSeek or not m_entry.value.m_validSeek)
+                    {
+                        m_remaining = 0;
+                    }
+                }
+                MapEntry m_entry;
+                uint32_t m_remaining;
+        };
+
+        /// Begin/end pair of iterators, usable in range based for loops.
+        template<class Iterator>
+        class Range
+        {
+            public:
+                Range(Iterator f_begin, Iterator f_end) : m_begin(f_begin), m_end(f_end) {}
+                Iterator begin() const
+                {
+                    return m_begin;
+                }
+                Iterator end() const
+                {
+                    return m_end;
+                }
+            private:
+                Iterator m_begin;
+                Iterator m_end;
+        };
+
+        /// Returns a range over all elements of the array at current position:
+        ///   for(auto & element : decoder.getArrayElements()) { element.getUint8(); }
+        /// If decoder does not refer to an array, the range is empty.
+        Range<ArrayIterator> getArrayElements() const;
+
+        /// Returns a range over all entries of the map at current position:
+        ///   for(auto & entry : decoder.getMapEntries()) { entry.key.compareString("a"); }
+        /// If decoder does not refer to a map, the range is empty.
+        /// Iteration stops early if the map is malformed.
+        Range<MapIterator> getMapEntries() const;
+
+        /// Walks the element at current position (including all nested
+        /// elements) once in message order and calls the matching function of
+        /// f_handler for each element:
+        ///   bool onMapBegin(uint32_t f_numEntries), bool onMapEnd(),
+        ///   bool onArrayBegin(uint32_t f_numElements), bool onArrayEnd(),
+        ///   bool onKey(std::string_view), bool onNil(), bool onBool(bool),
+        ///   bool onUint(uint64_t), bool onInt(int64_t), bool onFloat(float),
+        ///   bool onDouble(double), bool onString(std::string_view),
+        ///   bool onBinary(BinarySpan)
+        /// onKey() is called for string map keys, other keys are reported like
+        /// values. Derive from VisitorBase to only implement some of them.
+        /// Handler is a template parameter, so the calls can be inlined.
+        /// Only available for readers with contiguous data (see HasContiguousData).
+        /// @tparam MaxDepth maximum nesting depth of maps and arrays
+        /// @returns true if the whole element was visited, false if it is
+        ///          malformed, nested deeper than MaxDepth or a handler
+        ///          function returned false (aborts the walk).
+        template<uint32_t MaxDepth = 32, class Handler>
+        bool visit(Handler & f_handler) const;
 
         //---------------------------------------------------------------------
 
@@ -122,56 +802,165 @@ class GenericDecoder
         /// The following functions inspect data types:
 
         /// Not yet implemented
-        Maybe<uint8_t> getArraySize() const;
+        constexpr Maybe<uint32_t> getArraySize() const;
 
         /// If decoder refers to a map, return it's number of entries
         /// (number of entries = number of Key-Value-Pairs).
         /// If decoder does not refer to a map, returns invalid Maybe instance.
-        Maybe<uint8_t> getMapSize() const;
+        constexpr Maybe<uint32_t> getMapSize() const;
 
         /// Check if current seek position points to valid data
-        bool isValid();
+        constexpr bool isValid();
+
+        /// Element at a decoder position with its header decoded once.
+        /// Type checks and get<T>() calls on a Value do not decode the header
+        /// again:
+        ///   auto value = decoder["temp"].getValue();
+        ///   if(not value.isNil()) { value.get<int16_t>(); }
+        class Value
+        {
+            public:
+                /// If f_decoder is not validly seeked, the Value is invalid.
+                constexpr explicit Value(const GenericDecoder & f_decoder) :
+                    m_decoder(f_decoder)
+                {
+                    if(m_decoder.m_validSeek)
+                    {
+                        m_header = m_decoder.decodeHeader();
+                    }
+                }
+
+                constexpr bool isValid() const
+                {
+                    return m_header.headerType != HeaderInfo::InvalidHeader;
+                }
+
+                constexpr HeaderInfo::HeaderType getType() const
+                {
+                    return m_header.headerType;
+                }
+
+                constexpr bool isNil() const
+                {
+                    return m_header.headerType == HeaderInfo::Nil;
+                }
+
+                /// Number of map entries, array elements or string/binary
+                /// bytes. Invalid for other types.
+                constexpr Maybe<uint32_t> getSize() const
+                {
+                    if(m_header.headerType != HeaderInfo::Map and m_header.headerType != HeaderInfo::Array and m_header.headerType != HeaderInfo::String)
+                    {
+                        return Maybe<uint32_t>();
+                    }
+                    return Maybe<uint32_t>(m_header.numPayloadElements);
+                }
+
+                /// Same as GenericDecoder::get<Type>(), using the cached header.
+                template<class Type>
+                constexpr Maybe<Type> get() const
+                {
+                    return m_decoder.template decodeAs<Type>(m_header);
+                }
+
+                /// Decoder positioned at the element (e.g. to navigate into maps).
+                constexpr const GenericDecoder & getDecoder() const
+                {
+                    return m_decoder;
+                }
+
+            private:
+                GenericDecoder m_decoder;
+                HeaderInfo m_header;
+        };
+
+        /// Decodes the header of the current element once, see Value.
+        constexpr Value getValue() const
+        {
+            return Value(*this);
+        }
 
         //---------------------------------------------------------------------
 
         //---------------------------------------------------------------------
         /// The following functions access data members:
 
+        /// Decodes current element as Type with a single header decode.
+        /// Supported types:
+        ///  - bool
+        ///  - integers: any integer element (signed or unsigned encoding) is
+        ///    accepted, as long as its value fits into Type
+        ///  - float (float32 elements only), double (float32 or float64)
+        ///  - std::string_view, BinarySpan (pointing into the message,
+        ///    readers with contiguous data only, see HasContiguousData)
+        /// @returns the value if decoding was successful
+        template<class Type>
+        constexpr Maybe<Type> get() const
+        {
+            return decodeAs<Type>(decodeHeader());
+        }
+
         /// Decodes current element as a bool.
         /// @returns the boolean value if decoding was successful
-        Maybe<bool> getBool() const;
+        constexpr Maybe<bool> getBool() const;
 
         /// Checks if current element is set to "Nil"
         /// @returns true/false if decoding was successful
-        Maybe<bool> isNil() const;
+        constexpr Maybe<bool> isNil() const;
 
         /// Decodes current element as an uint32_t.
         /// @returns the integer if decoding was successful
-        Maybe<uint32_t> getUint32() const;
+        constexpr Maybe<uint32_t> getUint32() const;
 
         /// Decodes current element as an uint8_t.
         /// @returns the integer if decoding was successful
-        Maybe<uint8_t> getUint8() const;
+        constexpr Maybe<uint8_t> getUint8() const;
 
         /// Decodes current element as an uint16_t.
         /// @returns the integer if decoding was successful
-        Maybe<uint16_t> getUint16() const;
+        constexpr Maybe<uint16_t> getUint16() const;
+
+        /// Decodes current element as an uint64_t.
+        /// @returns the integer if decoding was successful
+        constexpr Maybe<uint64_t> getUint64() const;
+
+        /// Decodes current element as a signed integer.
+        /// Any integer element (signed or unsigned encoding) is accepted,
+        /// as long as its value fits into the requested type.
+        /// @returns the integer if decoding was successful
+        constexpr Maybe<int8_t> getInt8() const;
+        constexpr Maybe<int16_t> getInt16() const;
+        constexpr Maybe<int32_t> getInt32() const;
+        constexpr Maybe<int64_t> getInt64() const;
+
+        /// Decodes current element as a float (only float32 elements).
+        /// @returns the float if decoding was successful
+        Maybe<float> getFloat() const;
+
+        /// Decodes current element as a double (float32 or float64 elements).
+        /// @returns the double if decoding was successful
+        Maybe<double> getDouble() const;
 
         /// Reads a String from the MessagePack at current seek position.
         /// @param f_out_data buffer to which read string is written. Terminating '\0' is always added
         /// @returns length of the read string if read was successful
-        Maybe<uint16_t> getString(char * f_out_data, uint8_t f_maxSize) const;
+        Maybe<uint32_t> getString(char * f_out_data, PositionType f_maxSize) const;
 
         /// Compares the string from the MessagePack at current seek position with given string.
         /// @param f_string null terminated string to compare
         /// @returns true if strings match, false if strings do not match,
         ///          invalid if string could not be decoded
-        Maybe<bool> compareString(const char * f_string) const;
+        constexpr Maybe<bool> compareString(const char * f_string) const;
+
+        /// Same as compareString(const char *), for strings of known length
+        /// (f_string does not need to be null terminated). Strings of
+        /// different length are rejected without reading the payload.
+        constexpr Maybe<bool> compareString(const char * f_string, size_t f_length) const;
 
         /// Reads a Byte buffer from the MessagePack at current seek position.
         /// @param f_out_data buffer to which data is written.
         /// @returns number of bytes read if read was successful
-        Maybe<uint16_t> getBinary(uint8_t * f_out_data, uint8_t f_maxSize) const;
+        Maybe<uint32_t> getBinary(uint8_t * f_out_data, PositionType f_maxSize) const;
 
         /// Reads a Byte buffer from the MessagePack at current seek position.
         /// @param writer writer instance which will be used to write the binary data to.
@@ -181,44 +970,81 @@ class GenericDecoder
         ///               it is called for every byte to write
         /// @returns number of bytes read and written to writer if read was successful
         template<class Writer>
-        Maybe<uint16_t> getBinary(Writer & writer) const;
+        Maybe<uint32_t> getBinary(Writer & writer) const;
+
+        /// Returns a view of the String at current seek position, pointing
+        /// directly into the message buffer (no copy, no null termination).
+        /// Only available for readers with contiguous data (see HasContiguousData).
+        /// The view is only valid as long as the message buffer is.
+        Maybe<std::string_view> getStringView() const;
+
+        /// Returns a view of the Byte buffer at current seek position,
+        /// pointing directly into the message buffer (no copy).
+        /// Only available for readers with contiguous data (see HasContiguousData).
+        Maybe<BinarySpan> getBinarySpan() const;
         //---------------------------------------------------------------------
 
     private:
-        struct HeaderInfo
+        template<class, class>
+        friend class GenericIndexedDecoder;
+        template<class, class>
+        friend class GenericMessageSplitter;
+
+        using HeaderInfo = ZCMessagePack::HeaderInfo;
+
+        constexpr HeaderInfo decodeHeader() const;
+
+        constexpr uint8_t readRawByte(PositionType offset) const;
+
+        /// Decodes the element with given header at current position as Type
+        /// (see get<Type>()).
+        template<class Type>
+        constexpr Maybe<Type> decodeAs(const HeaderInfo & f_header) const;
+
+        /// Decodes any integer element with given header.
+        /// @param f_out_negative set if the value is negative, in that case
+        ///                       the returned bits are an int64_t.
+        /// @returns the value bits if decoding was successful
+        constexpr Maybe<uint64_t> getIntegerBits(const HeaderInfo & f_header, bool & f_out_negative) const;
+
+        /// Checks if the payload of the element with given header at current
+        /// position is within the message.
+        constexpr bool payloadFits(const HeaderInfo & f_header) const
         {
-            enum HeaderType
-            {
-                InvalidHeader,
-                Map,
-                Array,
-                Int,
-                Uint,
-                True,
-                False,
-                String,
-                Nil
-            };
-            uint8_t headerSize;
-            uint16_t numPayloadElements;
-            HeaderType headerType = InvalidHeader;
-        };
+            return static_cast<uint64_t>(m_position) + f_header.headerSize + f_header.numPayloadElements <= m_messageSize;
+        }
+
+        /// Reads an unsigned big endian number of Size bytes (up to 8).
+        template<uint8_t Size>
+        constexpr uint64_t readBigEndian(PositionType f_offset) const;
 
-        HeaderInfo decodeHeader() const;
+        /// Compares the payload of the string element with given header at
+        /// current position against f_string. Header needs to be validated.
+        constexpr bool comparePayload(const HeaderInfo & f_header, const char * f_string) const;
 
-        uint8_t readRawByte(uint8_t offset) const;
+        /// Same as comparePayload(), for strings of known length.
+        constexpr bool comparePayload(const HeaderInfo & f_header, const char * f_string, size_t f_length) const;
 
-        void seekNextElement();
+        /// Same as comparePayload(), checking length and prefix of f_key first.
+        constexpr bool comparePayload(const HeaderInfo & f_header, const Key & f_key) const;
+
+        constexpr void seekNextElement();
+
+        /// Advances m_position behind the element at current position
+        /// (including nested elements). The last element of a message ends
+        /// at m_messageSize.
+        /// @returns false if the element is malformed or truncated
+        constexpr bool skipElement();
 
         /// Set decoder position to map element with given index.
         /// Only works if current seek position is at a map, otherwise GenericDecoder
         /// is set to invalid seek.
         /// After successful seek, key can be read first 
-        void seekMapEntryByIndex(uint8_t f_index);
+        constexpr void seekMapEntryByIndex(uint32_t f_index);
 
         RawMessageReader m_raw_message_reader;
-        uint8_t m_messageSize;
-        uint8_t m_position = 0;
+        PositionType m_messageSize;
+        PositionType m_position = 0;
         uint8_t m_validSeek = true;
 };
 
@@ -226,6 +1052,9 @@ class GenericDecoder
 // You can use the special constructor to create a non-Generic Decoder using MemoryReader as the RawMessageReader.
 using Decoder = GenericDecoder<MemoryReader>;
 
+// Same as Decoder, but able to decode messages bigger than 255 bytes.
+using LargeDecoder = GenericDecoder<MemoryReader, uint32_t>;
+
 
 }
 
@@ -20,24 +20,129 @@
 
 namespace ZCMessagePack
 {
-template<class T>
-GenericDecoder<T> GenericDecoder<T>::operator[](const char * f_mapKey) const
+template<size_t MaxSteps>
+constexpr Path<MaxSteps>::Path(const char * f_path)
+{
+    size_t position = 0;
+    while(f_path[position] != '\0')
+    {
+        PathStep step;
+        if(f_path[position] == '[')
+        {
+            position++;
+            uint64_t index = 0;
+            size_t numDigits = 0;
+            for(; f_path[position] != ']'; position++, numDigits++)
+            {
+                char digit = f_path[position];
+                if(digit < '0' or digit > '9' or index > UINT32_MAX / 10)
+                {
+                    m_valid = false;
+                    return;
+                }
+                index = index * 10 + (digit - '0');
+            }
+            if(numDigits == 0 or index > UINT32_MAX)
+            {
+                m_valid = false;
+                return;
+            }
+            position++;
+            step.isIndex = true;
+            step.index = index;
+        }
+        else
+        {
+            if(m_numSteps > 0)
+            {
+                // keys after the first step need a separator
+                if(f_path[position] != '.')
+                {
+                    m_valid = false;
+                    return;
+                }
+                position++;
+            }
+            step.key = f_path + position;
+            while(f_path[position] != '\0' and f_path[position] != '.' and f_path[position] != '[')
+            {
+                position++;
+            }
+            step.keyLength = f_path + position - step.key;
+            if(step.keyLength == 0)
+            {
+                m_valid = false;
+                return;
+            }
+        }
+        if(m_numSteps == MaxSteps)
+        {
+            m_valid = false;
+            return;
+        }
+        m_steps[m_numSteps] = step;
+        m_numSteps++;
+    }
+}
+
+template<class T, class P, class I>
+constexpr GenericDecoder<T, P, I> GenericDecoder<T, P, I>::operator[](const char * f_mapKey) const
 {
     GenericDecoder newGenericDecoder = *this;
     newGenericDecoder.seekElementByKey(f_mapKey);
     return newGenericDecoder;
 }
 
-template<class T>
-GenericDecoder<T> GenericDecoder<T>::accessArray(uint8_t f_index) const
+template<class T, class P, class I>
+constexpr GenericDecoder<T, P, I> GenericDecoder<T, P, I>::operator[](const Key & f_mapKey) const
+{
+    GenericDecoder newGenericDecoder = *this;
+    newGenericDecoder.seekElementByKey(f_mapKey);
+    return newGenericDecoder;
+}
+
+template<class T, class P, class I>
+template<size_t MaxSteps>
+constexpr GenericDecoder<T, P, I> GenericDecoder<T, P, I>::operator[](const Path<MaxSteps> & f_path) const
+{
+    GenericDecoder newGenericDecoder = *this;
+    newGenericDecoder.seekPath(f_path);
+    return newGenericDecoder;
+}
+
+template<class T, class P, class I>
+template<size_t MaxSteps>
+constexpr void GenericDecoder<T, P, I>::seekPath(const Path<MaxSteps> & f_path)
+{
+    if(not f_path.isValid())
+    {
+        m_validSeek = false;
+        return;
+    }
+    for(size_t stepNumber = 0; stepNumber < f_path.getNumSteps() and m_validSeek; stepNumber++)
+    {
+        const PathStep & step = f_path.getStep(stepNumber);
+        if(step.isIndex)
+        {
+            seekElementByIndex(step.index);
+        }
+        else
+        {
+            seekElementByKey(step.key, step.keyLength);
+        }
+    }
+}
+
+template<class T, class P, class I>
+constexpr GenericDecoder<T, P, I> GenericDecoder<T, P, I>::accessArray(uint32_t f_index) const
 {
-    GenericDecoder<T> newGenericDecoder = *this;
+    GenericDecoder<T, P, I> newGenericDecoder = *this;
     newGenericDecoder.seekElementByIndex(f_index);
     return newGenericDecoder;
 }
 
-template<class T>
-void GenericDecoder<T>::seekElementByIndex(uint8_t f_index)
+template<class T, class P, class I>
+constexpr void GenericDecoder<T, P, I>::seekElementByIndex(uint32_t f_index)
 {
     if(not m_validSeek)
     {
@@ -58,17 +163,17 @@ void GenericDecoder<T>::seekElementByIndex(uint8_t f_index)
 
     m_position += header.headerSize;
 
-    for(uint16_t elementNumber = 0; elementNumber < f_index; elementNumber++)
+    for(uint32_t elementNumber = 0; elementNumber < f_index; elementNumber++)
     {
         seekNextElement();
     }
     return;
 }
 
-template<class T>
-GenericDecoder<T> GenericDecoder<T>::getMapEntryByIndex(uint8_t f_index, char * f_out_key, uint8_t f_maxSize)
+template<class T, class P, class I>
+GenericDecoder<T, P, I> GenericDecoder<T, P, I>::getMapEntryByIndex(uint32_t f_index, char * f_out_key, P f_maxSize)
 {
-    GenericDecoder<T> newGenericDecoder = *this;
+    GenericDecoder<T, P, I> newGenericDecoder = *this;
     newGenericDecoder.seekMapEntryByIndex(f_index);
     auto len = newGenericDecoder.getString(f_out_key, f_maxSize);
     if(not len.isValid())
@@ -80,8 +185,182 @@ GenericDecoder<T> GenericDecoder<T>::getMapEntryByIndex(uint8_t f_index, char *
     return newGenericDecoder;
 }
 
-template<class T>
-void GenericDecoder<T>::seekMapEntryByIndex(uint8_t f_index)
+template<class T, class P, class I>
+typename GenericDecoder<T, P, I>::template Range<typename GenericDecoder<T, P, I>::ArrayIterator> GenericDecoder<T, P, I>::getArrayElements() const
+{
+    GenericDecoder<T, P, I> firstElement = *this;
+    HeaderInfo header = decodeHeader();
+    if(not m_validSeek or header.headerType != HeaderInfo::Array)
+    {
+        return Range<ArrayIterator>(ArrayIterator(firstElement, 0), ArrayIterator(firstElement, 0));
+    }
+    firstElement.m_position += header.headerSize;
+    return Range<ArrayIterator>(ArrayIterator(firstElement, header.numPayloadElements), ArrayIterator(firstElement, 0));
+}
+
+template<class T, class P, class I>
+typename GenericDecoder<T, P, I>::template Range<typename GenericDecoder<T, P, I>::MapIterator> GenericDecoder<T, P, I>::getMapEntries() const
+{
+    GenericDecoder<T, P, I> firstKey = *this;
+    HeaderInfo header = decodeHeader();
+    if(not m_validSeek or header.headerType != HeaderInfo::Map)
+    {
+        return Range<MapIterator>(MapIterator(firstKey, 0), MapIterator(firstKey, 0));
+    }
+    firstKey.m_position += header.headerSize;
+    return Range<MapIterator>(MapIterator(firstKey, header.numPayloadElements), MapIterator(firstKey, 0));
+}
+
+template<class T, class P, class I>
+template<uint32_t MaxDepth, class Handler>
+bool GenericDecoder<T, P, I>::visit(Handler & f_handler) const
+{
+    static_assert(HasContiguousData<T>::value, "visit() requires a reader providing data()");
+    static_assert(MaxDepth > 0, "visit() requires MaxDepth > 0");
+    if(not m_validSeek)
+    {
+        return false;
+    }
+
+    // Per open map/array: number of children still to visit (maps count
+    // key and value) and if it is a map. Keys are at even counts.
+    uint64_t remainingChildren[MaxDepth] = {};
+    bool isMap[MaxDepth] = {};
+    uint32_t depth = 0;
+    GenericDecoder element = *this;
+    while(true)
+    {
+        HeaderInfo header = element.decodeHeader();
+        bool isKey = depth > 0 and isMap[depth - 1] and remainingChildren[depth - 1] % 2 == 0;
+        bool finished = true;
+        bool proceed = true;
+        switch(header.headerType)
+        {
+            case HeaderInfo::InvalidHeader:
+                return false;
+            case HeaderInfo::Map:
+            case HeaderInfo::Array:
+            {
+                bool map = header.headerType == HeaderInfo::Map;
+                if(header.numPayloadElements > 0 and depth == MaxDepth)
+                {
+                    // checked before the Begin callback, so the handler does
+                    // not see a container which is never ended
+                    return false;
+                }
+                element.m_position += header.headerSize;
+                proceed = map ? f_handler.onMapBegin(header.numPayloadElements) : f_handler.onArrayBegin(header.numPayloadElements);
+                if(header.numPayloadElements == 0)
+                {
+                    proceed = proceed and (map ? f_handler.onMapEnd() : f_handler.onArrayEnd());
+                }
+                else
+                {
+                    remainingChildren[depth] = map ? 2 * static_cast<uint64_t>(header.numPayloadElements) : header.numPayloadElements;
+                    isMap[depth] = map;
+                    depth++;
+                    finished = false;
+                }
+                break;
+            }
+            case HeaderInfo::Nil:
+                proceed = f_handler.onNil();
+                break;
+            case HeaderInfo::True:
+            case HeaderInfo::False:
+                proceed = f_handler.onBool(header.headerType == HeaderInfo::True);
+                break;
+            case HeaderInfo::Uint:
+            case HeaderInfo::Int:
+            {
+                bool negative = false;
+                auto bits = element.getIntegerBits(header, negative);
+                if(not bits.isValid())
+                {
+                    return false;
+                }
+                proceed = header.headerType == HeaderInfo::Uint ? f_handler.onUint(bits.get()) : f_handler.onInt(static_cast<int64_t>(bits.get()));
+                break;
+            }
+            case HeaderInfo::Float:
+            {
+                // the header is passed on, leaves are not decoded twice
+                if(header.numPayloadElements == sizeof(float))
+                {
+                    auto value = element.template decodeAs<float>(header);
+                    if(not value.isValid())
+                    {
+                        return false;
+                    }
+                    proceed = f_handler.onFloat(value.get());
+                }
+                else
+                {
+                    auto value = element.template decodeAs<double>(header);
+                    if(not value.isValid())
+                    {
+                        return false;
+                    }
+                    proceed = f_handler.onDouble(value.get());
+                }
+                break;
+            }
+            case HeaderInfo::String:
+            {
+                auto span = element.template decodeAs<BinarySpan>(header);
+                if(not span.isValid())
+                {
+                    return false;
+                }
+                uint8_t typeCode = readRawByte(element.m_position);
+                if(typeCode >= 0xc4 and typeCode <= 0xc6)
+                {
+                    proceed = f_handler.onBinary(span.get());
+                }
+                else
+                {
+                    std::string_view string(reinterpret_cast<const char *>(span.get().data), span.get().size);
+                    proceed = isKey ? f_handler.onKey(string) : f_handler.onString(string);
+                }
+                break;
+            }
+        }
+        if(not proceed)
+        {
+            return false;
+        }
+        if(not finished)
+        {
+            continue;
+        }
+        if(header.headerType != HeaderInfo::Map and header.headerType != HeaderInfo::Array)
+        {
+            element.m_position += header.headerSize + header.numPayloadElements;
+        }
+
+        // close all maps/arrays finished by this element:
+        while(true)
+        {
+            if(depth == 0)
+            {
+                return true;
+            }
+            remainingChildren[depth - 1]--;
+            if(remainingChildren[depth - 1] > 0)
+            {
+                break;
+            }
+            depth--;
+            if(not (isMap[depth] ? f_handler.onMapEnd() : f_handler.onArrayEnd()))
+            {
+                return false;
+            }
+        }
+    }
+}
+
+template<class T, class P, class I>
+constexpr void GenericDecoder<T, P, I>::seekMapEntryByIndex(uint32_t f_index)
 {
     if(not m_validSeek)
     {
@@ -103,7 +382,7 @@ void GenericDecoder<T>::seekMapEntryByIndex(uint8_t f_index)
 
     m_position += header.headerSize;
 
-    for(uint16_t elementNumber = 0; elementNumber < f_index; elementNumber++)
+    for(uint32_t elementNumber = 0; elementNumber < f_index; elementNumber++)
     {
             seekNextElement();
             seekNextElement();
@@ -111,40 +390,52 @@ void GenericDecoder<T>::seekMapEntryByIndex(uint8_t f_index)
     return;
 }
 
-template<class T>
-Maybe<uint8_t> GenericDecoder<T>::getMapSize() const
+template<class T, class P, class I>
+constexpr Maybe<uint32_t> GenericDecoder<T, P, I>::getMapSize() const
 {
     if(not m_validSeek)
     {
-        return Maybe<uint8_t>();
+        return Maybe<uint32_t>();
     }
 
     HeaderInfo header = decodeHeader();
     if(header.headerType != HeaderInfo::Map)
     {
-        return Maybe<uint8_t>();
+        return Maybe<uint32_t>();
     }
-    return Maybe<uint8_t>(header.numPayloadElements);
+    return Maybe<uint32_t>(header.numPayloadElements);
 }
 
-template<class T>
-Maybe<uint8_t> GenericDecoder<T>::getArraySize() const
+template<class T, class P, class I>
+constexpr Maybe<uint32_t> GenericDecoder<T, P, I>::getArraySize() const
 {
     if(not m_validSeek)
     {
-        return Maybe<uint8_t>();
+        return Maybe<uint32_t>();
     }
 
     HeaderInfo header = decodeHeader();
     if(header.headerType != HeaderInfo::Array)
     {
-        return Maybe<uint8_t>();
+        return Maybe<uint32_t>();
     }
-    return Maybe<uint8_t>(header.numPayloadElements);
+    return Maybe<uint32_t>(header.numPayloadElements);
+}
+
+template<class T, class P, class I>
+constexpr void GenericDecoder<T, P, I>::seekElementByKey(const char * f_key)
+{
+    seekElementByKey(Key(f_key));
 }
 
-template<class T>
-void GenericDecoder<T>::seekElementByKey(const char * f_key)
+template<class T, class P, class I>
+constexpr void GenericDecoder<T, P, I>::seekElementByKey(const char * f_key, size_t f_keyLength)
+{
+    seekElementByKey(Key(f_key, f_keyLength));
+}
+
+template<class T, class P, class I>
+constexpr void GenericDecoder<T, P, I>::seekElementByKey(const Key & f_key)
 {
     if(not m_validSeek)
     {
@@ -160,185 +451,193 @@ void GenericDecoder<T>::seekElementByKey(const char * f_key)
 
     m_position += header.headerSize;
 
-    for(uint16_t elementNumber = 0; elementNumber < header.numPayloadElements; elementNumber++)
+    for(uint32_t elementNumber = 0; elementNumber < header.numPayloadElements; elementNumber++)
     {
-        auto maybeKeyMatch = compareString(f_key);
-        if(not maybeKeyMatch.isValid())
+        HeaderInfo keyHeader = decodeHeader();
+        if(keyHeader.headerType != HeaderInfo::String or not payloadFits(keyHeader))
         {
             // key could not be decoded...
             m_validSeek = false;
             return;
         }
-        if(maybeKeyMatch.get())
+        bool match = comparePayload(keyHeader, f_key);
+        m_position += keyHeader.headerSize + keyHeader.numPayloadElements;
+        if(m_position >= m_messageSize)
         {
-            // key is a match, skip it to reach payload:
-            seekNextElement();
+            // value missing
+            m_validSeek = false;
             return;
         }
-        else
+        if(match)
         {
-            // key does not match, skip key and value:
-            seekNextElement();
-            seekNextElement();
+            return;
         }
+        // key does not match, skip value:
+        seekNextElement();
     }
     m_validSeek = false;
     return;
 }
 
-template<class T>
-void GenericDecoder<T>::seekNextElement()
+template<class T, class P, class I>
+uint8_t GenericDecoder<T, P, I>::getMapValues(const char * const * f_keys, GenericDecoder * f_out_values, uint8_t f_numKeys) const
 {
+    for(uint8_t keyNumber = 0; keyNumber < f_numKeys; keyNumber++)
+    {
+        f_out_values[keyNumber] = *this;
+        f_out_values[keyNumber].m_validSeek = false;
+    }
+
+    if(not m_validSeek)
+    {
+        return 0;
+    }
+
     HeaderInfo header = decodeHeader();
-    switch(header.headerType)
+    if(header.headerType != HeaderInfo::Map)
     {
-        case HeaderInfo::InvalidHeader:
-            m_validSeek = false;
-            return;
-        case HeaderInfo::Map:
-            m_position += header.headerSize;
-            for(uint16_t elementNumber = 0; elementNumber < header.numPayloadElements; elementNumber++)
-            {
-                uint32_t startpos = m_position;
-                seekNextElement();
-                seekNextElement();
-            }
-            return;
-        case HeaderInfo::Array:
-            m_position += header.headerSize;
-            for(uint16_t elementNumber = 0; elementNumber < header.numPayloadElements; elementNumber++)
+        return 0;
+    }
+
+    GenericDecoder cursor = *this;
+    cursor.m_position += header.headerSize;
+
+    uint8_t numFound = 0;
+    for(uint32_t elementNumber = 0; elementNumber < header.numPayloadElements and numFound < f_numKeys; elementNumber++)
+    {
+        HeaderInfo keyHeader = cursor.decodeHeader();
+        if(
+                keyHeader.headerType != HeaderInfo::String
+                or
+                not cursor.payloadFits(keyHeader)
+          )
+        {
+            // key could not be decoded...
+            return numFound;
+        }
+
+        // the key header is decoded once and compared against all keys not found yet:
+        P valuePosition = cursor.m_position + keyHeader.headerSize + keyHeader.numPayloadElements;
+        if(valuePosition >= m_messageSize)
+        {
+            // value missing
+            return numFound;
+        }
+        for(uint8_t keyNumber = 0; keyNumber < f_numKeys; keyNumber++)
+        {
+            if(not f_out_values[keyNumber].m_validSeek and cursor.comparePayload(keyHeader, f_keys[keyNumber]))
             {
-                seekNextElement();
+                f_out_values[keyNumber].m_position = valuePosition;
+                f_out_values[keyNumber].m_validSeek = true;
+                numFound++;
             }
-            return;
-        default:
-            m_position += header.headerSize + header.numPayloadElements;
+        }
+
+        cursor.m_position = valuePosition;
+        cursor.seekNextElement();
+        if(not cursor.m_validSeek)
+        {
+            return numFound;
+        }
     }
+    return numFound;
+}
 
-    if(m_position >= m_messageSize)
+template<class T, class P, class I>
+constexpr void GenericDecoder<T, P, I>::seekNextElement()
+{
+    I::onSeekNextElement();
+    if(not skipElement() or m_position >= m_messageSize)
     {
         m_validSeek = false;
     }
 }
 
-
-template<class T>
-typename GenericDecoder<T>::HeaderInfo GenericDecoder<T>::decodeHeader() const
+template<class T, class P, class I>
+constexpr bool GenericDecoder<T, P, I>::skipElement()
 {
-    HeaderInfo newHeaderInfo;
-    if(m_position >= m_messageSize)
+    // Instead of recursing into nested maps and arrays, their elements are
+    // added to the number of elements still to skip. This keeps stack usage
+    // constant regardless of the nesting depth.
+    uint64_t remainingElements = 1;
+    while(remainingElements > 0)
     {
-        return newHeaderInfo;
+        HeaderInfo header = decodeHeader();
+        remainingElements--;
+        switch(header.headerType)
+        {
+            case HeaderInfo::InvalidHeader:
+                return false;
+            case HeaderInfo::Map:
+                m_position += header.headerSize;
+                remainingElements += 2 * static_cast<uint64_t>(header.numPayloadElements);
+                break;
+            case HeaderInfo::Array:
+                m_position += header.headerSize;
+                remainingElements += header.numPayloadElements;
+                break;
+            default:
+                if(not payloadFits(header))
+                {
+                    m_position = m_messageSize;
+                    return false;
+                }
+                m_position += header.headerSize + header.numPayloadElements;
+        }
+
+        // every element needs at least one byte:
+        if(remainingElements > static_cast<uint64_t>(m_messageSize - m_position))
+        {
+            return false;
+        }
     }
-    uint8_t typeCode = readRawByte(m_position);
+    return true;
+}
 
-    newHeaderInfo.headerSize = 1;
-    newHeaderInfo.numPayloadElements = 0;
 
-    // compressed headers:
-    if((typeCode & 0x80) == 0)
-    {
-        newHeaderInfo.headerType = HeaderInfo::Uint;
-        return newHeaderInfo;
-    }
-    if((typeCode & 0xe0) == 0xe0)
-    {
-        newHeaderInfo.headerType = HeaderInfo::Int;
-        return newHeaderInfo;
-    }
-    if((typeCode & 0xe0) == 0xa0)
+// Called for every element touched (also while skipping). Defined in the
+// header (constexpr functions are implicitly inline, which only affects
+// linkage), so the compiler can inline it into the skip loops. Whether it
+// does is up to the optimizer, the table lookup pays off most if it does.
+template<class T, class P, class I>
+constexpr typename GenericDecoder<T, P, I>::HeaderInfo GenericDecoder<T, P, I>::decodeHeader() const
+{
+    I::onDecodeHeader();
+    HeaderInfo newHeaderInfo;
+    if(m_position >= m_messageSize)
     {
-        newHeaderInfo.headerType = HeaderInfo::String;
-        newHeaderInfo.numPayloadElements = typeCode & 0x1f;
         return newHeaderInfo;
     }
-    switch(typeCode & 0xf0)
-    {
-        case 0x90:
-            newHeaderInfo.headerType = HeaderInfo::Array;
-            newHeaderInfo.numPayloadElements = typeCode & 0x0f;
-            return newHeaderInfo;
-        case 0x80:
-            newHeaderInfo.headerType = HeaderInfo::Map;
-            newHeaderInfo.numPayloadElements = typeCode & 0x0f;
-            return newHeaderInfo;
-    }
 
-    // full headers:
-    switch(typeCode)
+    const TypeCodeInfo & info = typeCodeTable.entries[readRawByte(m_position)];
+    newHeaderInfo.headerSize = info.headerSize;
+    newHeaderInfo.numPayloadElements = info.numPayloadElements;
+    if(info.headerSize > 1)
     {
-        case 0xc0:
-            newHeaderInfo.headerType = HeaderInfo::Nil;
-            return newHeaderInfo;
-        case 0xc2:
-            newHeaderInfo.headerType = HeaderInfo::False;
-            return newHeaderInfo;
-        case 0xc3:
-            newHeaderInfo.headerType = HeaderInfo::True;
-            return newHeaderInfo;
-
-        case 0xcc:
-            newHeaderInfo.headerType = HeaderInfo::Uint;
-            newHeaderInfo.numPayloadElements = 1;
-            return newHeaderInfo;
-        case 0xcd:
-            newHeaderInfo.headerType = HeaderInfo::Uint;
-            newHeaderInfo.numPayloadElements = 2;
-            return newHeaderInfo;
-        case 0xce:
-            newHeaderInfo.headerType = HeaderInfo::Uint;
-            newHeaderInfo.numPayloadElements = 4;
-            return newHeaderInfo;
-
-        case 0xd0:
-            newHeaderInfo.headerType = HeaderInfo::Int;
-            newHeaderInfo.numPayloadElements = 1;
-            return newHeaderInfo;
-        case 0xd1:
-            newHeaderInfo.headerType = HeaderInfo::Int;
-            newHeaderInfo.numPayloadElements = 2;
-            return newHeaderInfo;
-        case 0xd2:
-            newHeaderInfo.headerType = HeaderInfo::Int;
-            newHeaderInfo.numPayloadElements = 4;
-            return newHeaderInfo;
-
-        case 0xd9:
-        case 0xc4:
-            if(m_messageSize - m_position < 2)
-            {
-                return newHeaderInfo;
-            }
-            newHeaderInfo.headerType = HeaderInfo::String;
-            newHeaderInfo.headerSize = 2;
-            newHeaderInfo.numPayloadElements = readRawByte(m_position + 1);
-            return newHeaderInfo;
-        case 0xdc:
-            if(m_messageSize - m_position < 3)
-            {
-                return newHeaderInfo;
-            }
-            newHeaderInfo.headerType = HeaderInfo::Array;
-            newHeaderInfo.headerSize = 3;
-            newHeaderInfo.numPayloadElements = (static_cast<uint16_t>(readRawByte(m_position + 1)) << 8) | readRawByte(m_position + 2);
-            return newHeaderInfo;
-        case 0xde:
-            if(m_messageSize - m_position < 3)
-            {
-                return newHeaderInfo;
-            }
-            newHeaderInfo.headerType = HeaderInfo::Map;
-            newHeaderInfo.headerSize = 3;
-            newHeaderInfo.numPayloadElements = (static_cast<uint16_t>(readRawByte(m_position + 1)) << 8) | readRawByte(m_position + 2);
+        if(m_messageSize - m_position < info.headerSize)
+        {
+            newHeaderInfo.headerSize = 1;
             return newHeaderInfo;
+        }
+        switch(info.headerSize)
+        {
+            case 2:
+                newHeaderInfo.numPayloadElements = readBigEndian<1>(m_position + 1);
+                break;
+            case 3:
+                newHeaderInfo.numPayloadElements = readBigEndian<2>(m_position + 1);
+                break;
+            default:
+                newHeaderInfo.numPayloadElements = readBigEndian<4>(m_position + 1);
+        }
     }
-
+    newHeaderInfo.headerType = static_cast<typename HeaderInfo::HeaderType>(info.headerType);
     return newHeaderInfo;
 }
 
 
-template<class T>
-Maybe<bool> GenericDecoder<T>::isNil() const
+template<class T, class P, class I>
+constexpr Maybe<bool> GenericDecoder<T, P, I>::isNil() const
 {
     HeaderInfo header = decodeHeader();
     if(header.headerType == HeaderInfo::Nil)
@@ -356,88 +655,246 @@ Maybe<bool> GenericDecoder<T>::isNil() const
     }
 }
 
-template<class T>
-Maybe<bool> GenericDecoder<T>::getBool() const
+template<class T, class P, class I>
+template<class Type>
+constexpr Maybe<Type> GenericDecoder<T, P, I>::decodeAs(const HeaderInfo & f_header) const
 {
-    HeaderInfo header = decodeHeader();
-    if(header.headerType == HeaderInfo::True)
+    if constexpr(std::is_same_v<Type, bool>)
     {
-        return Maybe<bool>(true);
+        if(f_header.headerType == HeaderInfo::True)
+        {
+            return Maybe<bool>(true);
+        }
+        else if(f_header.headerType == HeaderInfo::False)
+        {
+            return Maybe<bool>(false);
+        }
+        // type mismatch
+        return Maybe<bool>();
     }
-    else if(header.headerType == HeaderInfo::False)
+    else if constexpr(std::is_integral_v<Type>)
     {
-        return Maybe<bool>(false);
+        bool negative = false;
+        auto bits = getIntegerBits(f_header, negative);
+        if(not bits.isValid())
+        {
+            return Maybe<Type>();
+        }
+        if(negative)
+        {
+            if constexpr(std::is_unsigned_v<Type>)
+            {
+                return Maybe<Type>();
+            }
+            else
+            {
+                int64_t value = static_cast<int64_t>(bits.get());
+                if(value < std::numeric_limits<Type>::min())
+                {
+                    return Maybe<Type>();
+                }
+                return Maybe<Type>(static_cast<Type>(value));
+            }
+        }
+        if(bits.get() > static_cast<uint64_t>(std::numeric_limits<Type>::max()))
+        {
+            return Maybe<Type>();
+        }
+        return Maybe<Type>(static_cast<Type>(bits.get()));
+    }
+    else if constexpr(std::is_same_v<Type, float> or std::is_same_v<Type, double>)
+    {
+        if(f_header.headerType != HeaderInfo::Float or not payloadFits(f_header))
+        {
+            // type mismatch
+            return Maybe<Type>();
+        }
+        P payloadPosition = m_position + f_header.headerSize;
+        if(f_header.numPayloadElements == sizeof(float))
+        {
+            uint32_t bits = readBigEndian<sizeof(bits)>(payloadPosition);
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return Maybe<Type>(value);
+        }
+        if constexpr(std::is_same_v<Type, float>)
+        {
+            // no implicit narrowing of float64 elements
+            return Maybe<Type>();
+        }
+        else
+        {
+            if(f_header.numPayloadElements != sizeof(double))
+            {
+                // no float type code has another width
+                return Maybe<Type>();
+            }
+            uint64_t bits = readBigEndian<sizeof(bits)>(payloadPosition);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return Maybe<Type>(value);
+        }
+    }
+    else if constexpr(std::is_same_v<Type, std::string_view> or std::is_same_v<Type, BinarySpan>)
+    {
+        static_assert(HasContiguousData<T>::value, "get<std::string_view>()/get<BinarySpan>() require a reader providing data()");
+        if(f_header.headerType != HeaderInfo::String or not payloadFits(f_header))
+        {
+            // type mismatch
+            return Maybe<Type>();
+        }
+        const uint8_t * payload = m_raw_message_reader.data() + m_position + f_header.headerSize;
+        if constexpr(std::is_same_v<Type, std::string_view>)
+        {
+            return Maybe<Type>(std::string_view(reinterpret_cast<const char *>(payload), f_header.numPayloadElements));
+        }
+        else
+        {
+            BinarySpan span;
+            span.data = payload;
+            span.size = f_header.numPayloadElements;
+            return Maybe<Type>(span);
+        }
     }
     else
     {
-        // type mismatch
-        return Maybe<bool>();
+        static_assert(sizeof(Type) == 0, "unsupported type for get<Type>()");
     }
 }
 
-template<class T>
-Maybe<uint32_t> GenericDecoder<T>::getUint32() const
+template<class T, class P, class I>
+constexpr Maybe<bool> GenericDecoder<T, P, I>::getBool() const
+{
+    return get<bool>();
+}
+
+template<class T, class P, class I>
+constexpr Maybe<uint64_t> GenericDecoder<T, P, I>::getIntegerBits(const HeaderInfo & f_header, bool & f_out_negative) const
 {
-    HeaderInfo header = decodeHeader();
     if(
-            header.headerType != HeaderInfo::Uint
+            (f_header.headerType != HeaderInfo::Uint and f_header.headerType != HeaderInfo::Int)
             or
-            m_position + header.headerSize + header.numPayloadElements > m_messageSize
+            not payloadFits(f_header)
       )
     {
         // type mismatch
-        return Maybe<uint32_t>();
+        return Maybe<uint64_t>();
     }
-    switch(header.numPayloadElements)
+
+    P payloadPosition = m_position + f_header.headerSize;
+    int64_t value = 0;
+    if(f_header.headerType == HeaderInfo::Uint)
+    {
+        f_out_negative = false;
+        switch(f_header.numPayloadElements)
+        {
+            case 0:
+                return Maybe<uint64_t>(readRawByte(m_position) & 0x7f);
+            case 1:
+                return Maybe<uint64_t>(readBigEndian<1>(payloadPosition));
+            case 2:
+                return Maybe<uint64_t>(readBigEndian<2>(payloadPosition));
+            case 4:
+                return Maybe<uint64_t>(readBigEndian<4>(payloadPosition));
+            case 8:
+                return Maybe<uint64_t>(readBigEndian<8>(payloadPosition));
+            default:
+                // no integer type code has another width
+                return Maybe<uint64_t>();
+        }
+    }
+
+    // signed values are sign extended from their encoded size:
+    switch(f_header.numPayloadElements)
     {
         case 0:
-            return Maybe<uint32_t>(readRawByte(m_position) & 0x7f);
+            value = static_cast<int8_t>(readRawByte(m_position));
+            break;
         case 1:
-            return Maybe<uint32_t>(readRawByte(m_position + 1));
+            value = static_cast<int8_t>(readBigEndian<1>(payloadPosition));
+            break;
         case 2:
-            return Maybe<uint32_t>(static_cast<uint32_t>(readRawByte(m_position + 1)) << 8 | readRawByte(m_position + 2));
+            value = static_cast<int16_t>(readBigEndian<2>(payloadPosition));
+            break;
         case 4:
-            return Maybe<uint32_t>(static_cast<uint32_t>(readRawByte(m_position + 1)) << 24 | static_cast<uint32_t>(readRawByte(m_position + 2)) << 16 | static_cast<uint32_t>(readRawByte(m_position + 3)) << 8 | readRawByte(m_position + 4));
+            value = static_cast<int32_t>(readBigEndian<4>(payloadPosition));
+            break;
+        case 8:
+            value = static_cast<int64_t>(readBigEndian<8>(payloadPosition));
+            break;
         default:
-            // number too big
-            return Maybe<uint32_t>();
+            return Maybe<uint64_t>();
     }
+    f_out_negative = value < 0;
+    return Maybe<uint64_t>(static_cast<uint64_t>(value));
 }
 
-template<class T>
-Maybe<uint8_t> GenericDecoder<T>::getUint8() const
+template<class T, class P, class I>
+constexpr Maybe<uint64_t> GenericDecoder<T, P, I>::getUint64() const
 {
-    auto u32val = getUint32();
-    if((not u32val.isValid()) or u32val.get() > 0xff)
-    {
-        return Maybe<uint8_t>();
-    }
-    else
-    {
-        return Maybe<uint8_t>(u32val.get());
-    }
+    return get<uint64_t>();
 }
 
-template<class T>
-Maybe<uint16_t> GenericDecoder<T>::getUint16() const
+template<class T, class P, class I>
+constexpr Maybe<uint32_t> GenericDecoder<T, P, I>::getUint32() const
 {
-    auto u32val = getUint32();
-    if((not u32val.isValid()) or u32val.get() > 0xffff)
-    {
-        return Maybe<uint16_t>();
-    }
-    else
-    {
-        return Maybe<uint16_t>(u32val.get());
-    }
+    return get<uint32_t>();
+}
+
+template<class T, class P, class I>
+constexpr Maybe<uint16_t> GenericDecoder<T, P, I>::getUint16() const
+{
+    return get<uint16_t>();
+}
+
+template<class T, class P, class I>
+constexpr Maybe<uint8_t> GenericDecoder<T, P, I>::getUint8() const
+{
+    return get<uint8_t>();
+}
+
+template<class T, class P, class I>
+constexpr Maybe<int64_t> GenericDecoder<T, P, I>::getInt64() const
+{
+    return get<int64_t>();
+}
+
+template<class T, class P, class I>
+constexpr Maybe<int32_t> GenericDecoder<T, P, I>::getInt32() const
+{
+    return get<int32_t>();
 }
 
-template<class T>
-Maybe<uint16_t> GenericDecoder<T>::getString(char * f_out_data, uint8_t f_maxSize) const
+template<class T, class P, class I>
+constexpr Maybe<int16_t> GenericDecoder<T, P, I>::getInt16() const
+{
+    return get<int16_t>();
+}
+
+template<class T, class P, class I>
+constexpr Maybe<int8_t> GenericDecoder<T, P, I>::getInt8() const
+{
+    return get<int8_t>();
+}
+
+template<class T, class P, class I>
+Maybe<float> GenericDecoder<T, P, I>::getFloat() const
+{
+    return get<float>();
+}
+
+template<class T, class P, class I>
+Maybe<double> GenericDecoder<T, P, I>::getDouble() const
+{
+    return get<double>();
+}
+
+template<class T, class P, class I>
+Maybe<uint32_t> GenericDecoder<T, P, I>::getString(char * f_out_data, P f_maxSize) const
 {
     if(f_maxSize < 1)
     {
-        return Maybe<uint16_t>();
+        return Maybe<uint32_t>();
     }
     auto numBytes = getBinary(reinterpret_cast<uint8_t*>(f_out_data), f_maxSize - 1);
     if(numBytes.isValid())
@@ -451,85 +908,194 @@ Maybe<uint16_t> GenericDecoder<T>::getString(char * f_out_data, uint8_t f_maxSiz
     return numBytes;
 }
 
-template<class T>
-Maybe<bool> GenericDecoder<T>::compareString(const char * f_string) const
+template<class T, class P, class I>
+constexpr Maybe<bool> GenericDecoder<T, P, I>::compareString(const char * f_string) const
 {
     HeaderInfo header = decodeHeader();
     if(
             header.headerType != HeaderInfo::String
             or
-            m_position + header.headerSize + header.numPayloadElements > m_messageSize
+            not payloadFits(header)
       )
     {
         // type mismatch
         return Maybe<bool>();
     }
 
-    size_t i = 0;
-    for(; i < header.numPayloadElements; i++)
+    return Maybe<bool>(comparePayload(header, f_string));
+}
+
+template<class T, class P, class I>
+constexpr Maybe<bool> GenericDecoder<T, P, I>::compareString(const char * f_string, size_t f_length) const
+{
+    HeaderInfo header = decodeHeader();
+    if(
+            header.headerType != HeaderInfo::String
+            or
+            not payloadFits(header)
+      )
     {
-        char stored_char = static_cast<char>(readRawByte(m_position + header.headerSize + i));
-        if(f_string[i] == '\0' or stored_char != f_string[i])
+        // type mismatch
+        return Maybe<bool>();
+    }
+
+    return Maybe<bool>(comparePayload(header, f_string, f_length));
+}
+
+template<class T, class P, class I>
+constexpr bool GenericDecoder<T, P, I>::comparePayload(const HeaderInfo & f_header, const char * f_string, size_t f_length) const
+{
+    I::onKeyComparison();
+    if(f_header.numPayloadElements != f_length)
+    {
+        return false;
+    }
+    P payloadPosition = m_position + f_header.headerSize;
+    if constexpr(HasContiguousData<T>::value)
+    {
+        if(not isConstantEvaluated())
         {
-            return Maybe<bool>(false);
+            I::onBytesRead(f_length);
+            return equalBytes(m_raw_message_reader.data() + payloadPosition, f_string, f_length);
         }
     }
-    if(f_string[i] != '\0')
+
+    for(size_t i = 0; i < f_length; i++)
     {
-        return Maybe<bool>(false);
+        if(static_cast<char>(readRawByte(payloadPosition + i)) != f_string[i])
+        {
+            return false;
+        }
     }
-    return Maybe<bool>(true);
+    return true;
 }
 
-template<class T>
-Maybe<uint16_t> GenericDecoder<T>::getBinary(uint8_t * f_out_data, uint8_t f_maxSize) const
+template<class T, class P, class I>
+constexpr bool GenericDecoder<T, P, I>::comparePayload(const HeaderInfo & f_header, const Key & f_key) const
+{
+    if constexpr(HasContiguousData<T>::value)
+    {
+        P payloadPosition = m_position + f_header.headerSize;
+        // the prefix is loaded as a whole word, which must be within the message
+        if(not isConstantEvaluated() and static_cast<uint64_t>(payloadPosition) + 8 <= m_messageSize)
+        {
+            I::onKeyComparison();
+            if(f_header.numPayloadElements != f_key.size())
+            {
+                return false;
+            }
+            const uint8_t * stored = m_raw_message_reader.data() + payloadPosition;
+            if((loadLittleEndianWord(stored) & f_key.getPrefixMask()) != f_key.getPrefix())
+            {
+                I::onBytesRead(f_key.size() < 8 ? f_key.size() : 8);
+                return false;
+            }
+            I::onBytesRead(f_key.size());
+            return f_key.size() <= 8 or equalBytes(stored + 8, f_key.data() + 8, f_key.size() - 8);
+        }
+    }
+    return comparePayload(f_header, f_key.data(), f_key.size());
+}
+
+template<class T, class P, class I>
+constexpr bool GenericDecoder<T, P, I>::comparePayload(const HeaderInfo & f_header, const char * f_string) const
+{
+    I::onKeyComparison();
+    P payloadPosition = m_position + f_header.headerSize;
+    if constexpr(HasContiguousData<T>::value)
+    {
+        if(not isConstantEvaluated())
+        {
+            const uint8_t * stored = m_raw_message_reader.data() + payloadPosition;
+            I::onBytesRead(f_header.numPayloadElements);
+            return
+                strnlen(f_string, f_header.numPayloadElements + 1) == f_header.numPayloadElements
+                and
+                equalBytes(stored, f_string, f_header.numPayloadElements);
+        }
+    }
+
+    size_t i = 0;
+    for(; i < f_header.numPayloadElements; i++)
+    {
+        char stored_char = static_cast<char>(readRawByte(payloadPosition + i));
+        if(f_string[i] == '\0' or stored_char != f_string[i])
+        {
+            return false;
+        }
+    }
+    return f_string[i] == '\0';
+}
+
+template<class T, class P, class I>
+Maybe<uint32_t> GenericDecoder<T, P, I>::getBinary(uint8_t * f_out_data, P f_maxSize) const
 {
     HeaderInfo header = decodeHeader();
     if(
             header.headerType != HeaderInfo::String
             or
-            m_position + header.headerSize + header.numPayloadElements > m_messageSize
+            not payloadFits(header)
             or
             header.numPayloadElements > f_maxSize
       )
     {
         // type mismatch
-        return Maybe<uint16_t>();
+        return Maybe<uint32_t>();
     }
 
-    m_raw_message_reader.read(m_position + header.headerSize, header.numPayloadElements, f_out_data);
-    return Maybe<uint16_t>(header.numPayloadElements);
+    I::onBytesRead(header.numPayloadElements);
+    if constexpr(HasContiguousData<T>::value)
+    {
+        std::memcpy(f_out_data, m_raw_message_reader.data() + m_position + header.headerSize, header.numPayloadElements);
+    }
+    else
+    {
+        m_raw_message_reader.read(static_cast<P>(m_position + header.headerSize), static_cast<P>(header.numPayloadElements), f_out_data);
+    }
+    return Maybe<uint32_t>(header.numPayloadElements);
 }
 
-template<class T>
+template<class T, class P, class I>
 template<class Writer>
-Maybe<uint16_t> GenericDecoder<T>::getBinary(Writer & writer) const
+Maybe<uint32_t> GenericDecoder<T, P, I>::getBinary(Writer & writer) const
 {
     HeaderInfo header = decodeHeader();
     if(
             header.headerType != HeaderInfo::String
             or
-            m_position + header.headerSize + header.numPayloadElements > m_messageSize
+            not payloadFits(header)
       )
     {
         // type mismatch
-        return Maybe<uint16_t>();
+        return Maybe<uint32_t>();
     }
 
-    for(uint16_t i = 0; i < header.numPayloadElements; i++)
+    for(uint32_t i = 0; i < header.numPayloadElements; i++)
     {
-        bool success = writer.write(readRawByte(m_position + header.headerSize + i));
+        bool success = writer.write(readRawByte(static_cast<P>(m_position + header.headerSize + i)));
         if(not success)
         {
-            return Maybe<uint16_t>();
+            return Maybe<uint32_t>();
         }
     }
-    return Maybe<uint16_t>(header.numPayloadElements);
+    return Maybe<uint32_t>(header.numPayloadElements);
 }
 
 
-template<class T>
-bool GenericDecoder<T>::isValid()
+template<class T, class P, class I>
+Maybe<std::string_view> GenericDecoder<T, P, I>::getStringView() const
+{
+    return get<std::string_view>();
+}
+
+template<class T, class P, class I>
+Maybe<BinarySpan> GenericDecoder<T, P, I>::getBinarySpan() const
+{
+    return get<BinarySpan>();
+}
+
+template<class T, class P, class I>
+constexpr bool GenericDecoder<T, P, I>::isValid()
 {
     auto header = decodeHeader();
     if(header.headerType == HeaderInfo::InvalidHeader)
@@ -539,12 +1105,38 @@ bool GenericDecoder<T>::isValid()
     return m_validSeek;
 }
 
-template<class T>
-uint8_t ZCMessagePack::GenericDecoder<T>::readRawByte(uint8_t offset) const
+template<class T, class P, class I>
+template<uint8_t Size>
+constexpr uint64_t GenericDecoder<T, P, I>::readBigEndian(P f_offset) const
 {
-    uint8_t result;
-    m_raw_message_reader.read(offset, 1, &result);
+    // for contiguous readers compilers turn this into a single load + byte swap
+    if constexpr(HasContiguousData<T>::value)
+    {
+        I::onBytesRead(Size);
+        return loadBigEndian(m_raw_message_reader.data() + f_offset, std::make_index_sequence<Size>());
+    }
+    uint64_t result = 0;
+    for(uint8_t i = 0; i < Size; i++)
+    {
+        result = (result << 8) | readRawByte(f_offset + i);
+    }
     return result;
 }
 
+template<class T, class P, class I>
+constexpr uint8_t GenericDecoder<T, P, I>::readRawByte(P offset) const
+{
+    I::onBytesRead(1);
+    if constexpr(HasContiguousData<T>::value)
+    {
+        return m_raw_message_reader.data()[offset];
+    }
+    else
+    {
+        uint8_t result = 0;
+        m_raw_message_reader.read(offset, static_cast<P>(1), &result);
+        return result;
+    }
+}
+
 }
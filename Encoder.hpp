@@ -18,7 +18,10 @@
 
 namespace ZCMessagePack
 {
-class Encoder
+/// PositionType is the unsigned integer type used for offsets and sizes within
+/// the message buffer. It limits the maximum message size (uint8_t: 255 bytes).
+template<class PositionType = uint8_t>
+class GenericEncoder
 {
     public:
         /// Constructs the encoder.
@@ -26,20 +29,33 @@ class Encoder
         /// encoded data to.
         /// NOTE: The Encoder does not yet support generic memory backend.
         ///       (The Decoder does support it)
-        Encoder(uint8_t * f_out_borrow_messageBuffer, uint8_t f_bufferSize);
+        GenericEncoder(uint8_t * f_out_borrow_messageBuffer, PositionType f_bufferSize);
 
         /// Encodes an unsigned integer into the buffer.
-        bool addUint(uint32_t f_number);
+        /// The smallest possible representation is used.
+        bool addUint(uint64_t f_number);
 
-        // EXPERIMENTAL
-        bool addInt(int32_t f_number);
+        /// Encodes a signed integer into the buffer.
+        /// The smallest possible representation is used, positive numbers
+        /// are encoded like unsigned integers.
+        bool addInt(int64_t f_number);
+
+        /// Encodes a float (float32) into the buffer.
+        bool addFloat(float f_number);
+
+        /// Encodes a double (float64) into the buffer.
+        bool addDouble(double f_number);
 
         /// Encodes a string into the buffer.
         /// f_string needs to be null terminated.
         bool addString(const char * f_string);
 
+        /// Encodes a string of given length into the buffer.
+        /// f_string does not need to be null terminated.
+        bool addString(const char * f_string, PositionType f_length);
+
         /// Encodes given binary data into the buffer.
-        bool addBinary(const uint8_t * f_data, uint8_t f_size);
+        bool addBinary(const uint8_t * f_data, PositionType f_size);
 
         /// Encodes given boolean value into the buffer.
         bool addBool(bool f_value);
@@ -53,23 +69,42 @@ class Encoder
         ///       f_numElements times:
         ///         - a string
         ///         - any MessagePack element
-        bool addMap(uint8_t f_numElements);
+        bool addMap(uint32_t f_numElements);
 
         /// Add an Array header for the given number of elements.
         /// NOTE: The user needs to ensure that the resulting message is well formed.
         ///       After this header f_numElements need to be encoded.
-        bool addArray(uint8_t f_numElements);
+        bool addArray(uint32_t f_numElements);
 
         /// Returns the size of the encoded message
-        uint8_t getMessageSize() const;
+        PositionType getMessageSize() const;
 
     private:
-        uint8_t sizeLeft();
+        PositionType sizeLeft();
+
+        bool addNestedStructure(uint32_t f_numElements, uint8_t f_smallPrefix, uint8_t f_bigPrefix);
+
+        bool addStringPayload(const char * f_string, size_t f_length);
 
-        bool addNestedStructure(uint8_t f_numElements, uint8_t f_smallPrefix, uint8_t f_bigPrefix);
+        /// Writes a str/bin header (8, 16 or 32 bit length) followed by the payload.
+        /// @param f_prefix8 type code of the 8 bit length variant
+        bool addLengthPrefixed(uint8_t f_prefix8, const uint8_t * f_data, size_t f_size);
+
+        /// Writes the type code followed by f_size bytes of f_value (big endian).
+        bool addFixedSize(uint8_t f_typeCode, uint64_t f_value, uint8_t f_size);
 
         uint8_t * m_messageBuffer;
-        uint8_t m_bufferSize;
-        uint8_t m_position = 0;
+        PositionType m_bufferSize;
+        PositionType m_position = 0;
 };
+
+// The default (embedded) encoder is compiled once into the library.
+extern template class GenericEncoder<uint8_t>;
+
+using Encoder = GenericEncoder<uint8_t>;
+
+// Same as Encoder, but able to encode messages bigger than 255 bytes.
+using LargeEncoder = GenericEncoder<uint32_t>;
 }
+
+#include "Encoder_impl.hpp"
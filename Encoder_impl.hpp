@@ -0,0 +1,291 @@
+// Copyright 2021 Rainer Schoenberger
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <inttypes.h>
+#include <string.h>
+#include <cstring>
+#include "Encoder.hpp"
+
+namespace ZCMessagePack
+{
+template<class P>
+GenericEncoder<P>::GenericEncoder(uint8_t * f_out_borrow_messageBuffer, P f_bufferSize) :
+    m_messageBuffer(f_out_borrow_messageBuffer),
+    m_bufferSize(f_bufferSize)
+{
+}
+
+template<class P>
+bool GenericEncoder<P>::addInt(int64_t f_number)
+{
+    if(f_number >= 0)
+    {
+        return addUint(f_number);
+    }
+    else if(f_number >= -32)
+    {
+        if(sizeLeft() < 1)
+        {
+            return false;
+        }
+        m_messageBuffer[m_position] = f_number;
+        m_position += 1;
+        return true;
+    }
+    else if(f_number >= INT8_MIN)
+    {
+        return addFixedSize(0xd0, f_number, 1);
+    }
+    else if(f_number >= INT16_MIN)
+    {
+        return addFixedSize(0xd1, f_number, 2);
+    }
+    else if(f_number >= INT32_MIN)
+    {
+        return addFixedSize(0xd2, f_number, 4);
+    }
+    return addFixedSize(0xd3, f_number, 8);
+}
+
+template<class P>
+bool GenericEncoder<P>::addUint(uint64_t f_number)
+{
+    if(f_number <= 0x7f)
+    {
+        if(sizeLeft() < 1)
+        {
+            return false;
+        }
+        m_messageBuffer[m_position] = f_number;
+        m_position += 1;
+    }
+    else if(f_number <= 0xff)
+    {
+        if(sizeLeft() < 2)
+        {
+            return false;
+        }
+        m_messageBuffer[m_position] = 0xcc;
+        m_messageBuffer[m_position+1] = f_number;
+        m_position += 2;
+    }
+    else if(f_number <= 0xffff)
+    {
+        if(sizeLeft() < 3)
+        {
+            return false;
+        }
+        m_messageBuffer[m_position] = 0xcd;
+        m_messageBuffer[m_position+1] = f_number>>8;
+        m_messageBuffer[m_position+2] = f_number;
+        m_position += 3;
+    }
+    else if(f_number <= 0xffffffff)
+    {
+        if(sizeLeft() < 5)
+        {
+            return false;
+        }
+        m_messageBuffer[m_position] = 0xce;
+        m_messageBuffer[m_position+1] = f_number>>24;
+        m_messageBuffer[m_position+2] = f_number>>16;
+        m_messageBuffer[m_position+3] = f_number>>8;
+        m_messageBuffer[m_position+4] = f_number;
+        m_position += 5;
+    }
+    else
+    {
+        return addFixedSize(0xcf, f_number, 8);
+    }
+    return true;
+}
+
+template<class P>
+bool GenericEncoder<P>::addFloat(float f_number)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f_number, sizeof(bits));
+    return addFixedSize(0xca, bits, sizeof(bits));
+}
+
+template<class P>
+bool GenericEncoder<P>::addDouble(double f_number)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &f_number, sizeof(bits));
+    return addFixedSize(0xcb, bits, sizeof(bits));
+}
+
+template<class P>
+bool GenericEncoder<P>::addString(const char * f_string)
+{
+    return addStringPayload(f_string, strlen(f_string));
+}
+
+template<class P>
+bool GenericEncoder<P>::addString(const char * f_string, P f_length)
+{
+    return addStringPayload(f_string, f_length);
+}
+
+template<class P>
+bool GenericEncoder<P>::addStringPayload(const char * f_string, size_t f_length)
+{
+    if(f_length <= 0x1f)
+    {
+        if(sizeLeft() < f_length+1)
+        {
+            return false;
+        }
+        m_messageBuffer[m_position] = 0xa0 | f_length;
+        m_position += 1;
+        memcpy(&m_messageBuffer[m_position], f_string, f_length);
+        m_position += f_length;
+    }
+    else
+    {
+        return addLengthPrefixed(0xd9, reinterpret_cast<const uint8_t *>(f_string), f_length);
+    }
+    return true;
+}
+
+template<class P>
+bool GenericEncoder<P>::addBinary(const uint8_t * f_data, P f_size)
+{
+    return addLengthPrefixed(0xc4, f_data, f_size);
+}
+
+template<class P>
+bool GenericEncoder<P>::addBool(bool f_value)
+{
+    if(sizeLeft() < 1)
+    {
+        return false;
+    }
+    m_messageBuffer[m_position] = f_value ? 0xc3 : 0xc2;
+    m_position += 1;
+    return true;
+}
+
+template<class P>
+bool GenericEncoder<P>::addNil()
+{
+    if(sizeLeft() < 1)
+    {
+        return false;
+    }
+    m_messageBuffer[m_position] = 0xc0;
+    m_position += 1;
+    return true;
+}
+
+template<class P>
+bool GenericEncoder<P>::addMap(uint32_t f_numElements)
+{
+    return addNestedStructure(f_numElements, 0x80, 0xde);
+}
+
+template<class P>
+bool GenericEncoder<P>::addArray(uint32_t f_numElements)
+{
+    return addNestedStructure(f_numElements, 0x90, 0xdc);
+}
+
+template<class P>
+P GenericEncoder<P>::getMessageSize() const
+{
+    return m_position;
+}
+template<class P>
+P GenericEncoder<P>::sizeLeft()
+{
+    return m_bufferSize - m_position;
+}
+template<class P>
+bool GenericEncoder<P>::addNestedStructure(uint32_t f_numElements, uint8_t f_smallPrefix, uint8_t f_bigPrefix)
+{
+    if(f_numElements <= 0x0f)
+    {
+        if(sizeLeft() < 1)
+        {
+            return false;
+        }
+        m_messageBuffer[m_position] = f_smallPrefix | f_numElements;
+        m_position += 1;
+    }
+    else if(f_numElements <= 0xffff)
+    {
+        return addFixedSize(f_bigPrefix, f_numElements, 2);
+    }
+    else
+    {
+        // 32 bit variant directly follows the 16 bit type code
+        return addFixedSize(f_bigPrefix + 1, f_numElements, 4);
+    }
+    return true;
+}
+
+template<class P>
+bool GenericEncoder<P>::addLengthPrefixed(uint8_t f_prefix8, const uint8_t * f_data, size_t f_size)
+{
+    // 16 and 32 bit variants directly follow the 8 bit type code
+    uint8_t prefix;
+    uint8_t lengthSize;
+    if(f_size <= 0xff)
+    {
+        prefix = f_prefix8;
+        lengthSize = 1;
+    }
+    else if(f_size <= 0xffff)
+    {
+        prefix = f_prefix8 + 1;
+        lengthSize = 2;
+    }
+    else if(static_cast<uint64_t>(f_size) <= 0xffffffff)
+    {
+        prefix = f_prefix8 + 2;
+        lengthSize = 4;
+    }
+    else
+    {
+        return false;
+    }
+
+    if(static_cast<uint64_t>(sizeLeft()) < 1 + lengthSize + static_cast<uint64_t>(f_size))
+    {
+        return false;
+    }
+    addFixedSize(prefix, f_size, lengthSize);
+    memcpy(&m_messageBuffer[m_position], f_data, f_size);
+    m_position += f_size;
+    return true;
+}
+
+template<class P>
+bool GenericEncoder<P>::addFixedSize(uint8_t f_typeCode, uint64_t f_value, uint8_t f_size)
+{
+    if(sizeLeft() < static_cast<uint32_t>(f_size) + 1)
+    {
+        return false;
+    }
+    m_messageBuffer[m_position] = f_typeCode;
+    for(uint8_t i = 0; i < f_size; i++)
+    {
+        m_messageBuffer[m_position + f_size - i] = f_value >> (8 * i);
+    }
+    m_position += f_size + 1;
+    return true;
+}
+}
@@ -0,0 +1,454 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <inttypes.h>
+#include <string.h>
+#include <utility>
+#include "Decoder.hpp"
+
+namespace ZCMessagePack
+{
+/// Decoder which walks the message once and records the structure of all
+/// elements in a user-allocated index ("tape").
+/// Afterwards navigation does not need to skip over elements anymore:
+/// accessArray() and getMapSize() are constant time, operator[] is a binary
+/// search over the keys of the addressed map (O(log n keys)).
+///
+/// Children of a map or array are stored next to each other in the index
+/// (maps: key, value, key, value, ...), so array element i is found at
+/// firstChild + i. The key/value pairs of a map are sorted in place by key
+/// (length first, then bytes) while the index is built, so they are not in
+/// message order. Maps having a non-string key are kept in message order and
+/// searched linearly.
+template<class RawMessageReader, class PositionType = uint8_t>
+class GenericIndexedDecoder
+{
+    public:
+        using Decoder = GenericDecoder<RawMessageReader, PositionType>;
+
+        /// One element of the message in the index.
+        struct Entry
+        {
+            /// Offset of the element header in the message.
+            PositionType offset;
+            /// Offset directly behind the element (including nested elements).
+            PositionType end;
+            /// Index of the first child entry (only for maps and arrays).
+            PositionType firstChild;
+            /// Number of map entries, array elements or payload bytes.
+            uint32_t numElements;
+            uint8_t headerType;
+            /// Maps only: key/value pairs are sorted by key.
+            bool sortedKeys;
+        };
+
+        /// Builds the index for the element f_decoder currently refers to.
+        /// @param f_out_borrow_entries user-allocated buffer for the index.
+        ///                             Needs one entry per element (map entries
+        ///                             count as two: key and value) and must
+        ///                             outlive this decoder.
+        /// If the message is malformed or f_maxEntries is too small, the
+        /// returned decoder is invalid.
+        GenericIndexedDecoder(const Decoder & f_decoder, Entry * f_out_borrow_entries, PositionType f_maxEntries);
+
+        /// Returns a new decoder which refers to the map value matching given key.
+        GenericIndexedDecoder operator[](const char * f_mapKey) const;
+
+        /// Returns a new decoder which refers to the given array index.
+        /// If f_index is out of range, the decoder will become invalid.
+        GenericIndexedDecoder accessArray(uint32_t f_index) const;
+
+        /// If decoder refers to a map, return it's number of entries.
+        Maybe<uint32_t> getMapSize() const;
+
+        /// If decoder refers to an array, return it's number of elements.
+        Maybe<uint32_t> getArraySize() const;
+
+        /// Check if decoder refers to a valid element.
+        bool isValid() const
+        {
+            return m_valid;
+        }
+
+        /// Returns a GenericDecoder seeked to the current element, which can
+        /// be used to read its value.
+        Decoder getDecoder() const;
+
+        /// Number of index entries used by the message.
+        PositionType getNumEntries() const
+        {
+            return m_numEntries;
+        }
+
+    private:
+        using HeaderInfo = typename Decoder::HeaderInfo;
+
+        bool buildIndex(Decoder f_decoder, Entry * f_out_entries, PositionType f_maxEntries);
+
+        /// Sorts the key/value pairs of a finished map by key (heap sort, in
+        /// place). Leaves maps with non-string keys untouched.
+        void sortMap(Entry & f_map, Entry * f_out_entries) const;
+
+        /// Orders the string key entry f_key relative to f_string: by length,
+        /// then bytewise. Returns <0, 0 or >0.
+        int compareKey(const Entry & f_key, const char * f_string, size_t f_length) const;
+
+        /// Orders two string key entries like compareKey(), keys which are
+        /// equal by their position in the message.
+        int compareKeys(const Entry & f_left, const Entry & f_right) const;
+
+        /// First (up to) 8 payload bytes of a string key entry, big endian,
+        /// so keys of equal length are ordered like their bytes.
+        uint64_t keyPrefix(const Entry & f_key) const;
+
+        static uint64_t numChildren(const Entry & f_entry)
+        {
+            return f_entry.headerType == HeaderInfo::Map ? 2 * static_cast<uint64_t>(f_entry.numElements) : f_entry.numElements;
+        }
+
+        Decoder m_decoder;
+        const Entry * m_entries;
+        PositionType m_numEntries = 0;
+        PositionType m_entry = 0;
+        bool m_valid = false;
+};
+
+// Convenience typedef for an GenericIndexedDecoder using MemoryReader as the RawMessageReader.
+using IndexedDecoder = GenericIndexedDecoder<MemoryReader>;
+
+template<class T, class P>
+GenericIndexedDecoder<T, P>::GenericIndexedDecoder(const Decoder & f_decoder, Entry * f_out_borrow_entries, P f_maxEntries) :
+    m_decoder(f_decoder),
+    m_entries(f_out_borrow_entries)
+{
+    m_valid = buildIndex(f_decoder, f_out_borrow_entries, f_maxEntries);
+}
+
+template<class T, class P>
+bool GenericIndexedDecoder<T, P>::buildIndex(Decoder f_decoder, Entry * f_out_entries, P f_maxEntries)
+{
+    if(not f_decoder.m_validSeek or f_maxEntries < 1)
+    {
+        return false;
+    }
+
+    // Entries are filled in message order. Children of a container are
+    // reserved as one block when the container is reached.
+    // While a container is being filled, its "end" member temporarily holds
+    // the index of its parent, so no stack is needed to walk back up.
+    P numEntries = 1;
+    P slot = 0;
+    P parent = 0;
+    while(true)
+    {
+        HeaderInfo header = f_decoder.decodeHeader();
+        if(header.headerType == HeaderInfo::InvalidHeader)
+        {
+            return false;
+        }
+
+        Entry & entry = f_out_entries[slot];
+        entry.offset = f_decoder.m_position;
+        entry.firstChild = numEntries;
+        entry.numElements = header.numPayloadElements;
+        entry.headerType = header.headerType;
+        entry.sortedKeys = false;
+
+        if(header.headerType == HeaderInfo::Map or header.headerType == HeaderInfo::Array)
+        {
+            uint64_t childCount = numChildren(entry);
+            if(childCount > static_cast<uint64_t>(f_maxEntries - numEntries))
+            {
+                // index buffer too small
+                return false;
+            }
+            numEntries += childCount;
+            f_decoder.m_position += header.headerSize;
+            if(childCount > 0)
+            {
+                entry.end = parent;
+                parent = slot;
+                slot = entry.firstChild;
+                continue;
+            }
+        }
+        else
+        {
+            if(not f_decoder.payloadFits(header))
+            {
+                // truncated message
+                return false;
+            }
+            f_decoder.m_position += header.headerSize + header.numPayloadElements;
+        }
+        entry.end = f_decoder.m_position;
+
+        // advance to the next element, closing all finished containers:
+        while(true)
+        {
+            if(slot == 0)
+            {
+                m_numEntries = numEntries;
+                return true;
+            }
+            Entry & parentEntry = f_out_entries[parent];
+            if(static_cast<uint64_t>(slot) + 1 < parentEntry.firstChild + numChildren(parentEntry))
+            {
+                slot++;
+                break;
+            }
+            P grandParent = parentEntry.end;
+            parentEntry.end = f_decoder.m_position;
+            if(parentEntry.headerType == HeaderInfo::Map)
+            {
+                // all children are finished, moving them does not break
+                // the parent links of unfinished containers
+                sortMap(parentEntry, f_out_entries);
+            }
+            slot = parent;
+            parent = grandParent;
+        }
+    }
+}
+
+template<class T, class P>
+void GenericIndexedDecoder<T, P>::sortMap(Entry & f_map, Entry * f_out_entries) const
+{
+    Entry * pairs = f_out_entries + f_map.firstChild;
+    uint32_t numPairs = f_map.numElements;
+    for(uint32_t pair = 0; pair < numPairs; pair++)
+    {
+        if(pairs[2 * pair].headerType != HeaderInfo::String)
+        {
+            return;
+        }
+    }
+
+    auto less = [&](uint32_t f_left, uint32_t f_right) {
+        return compareKeys(pairs[2 * f_left], pairs[2 * f_right]) < 0;
+    };
+    auto swapPairs = [&](uint32_t f_left, uint32_t f_right) {
+        std::swap(pairs[2 * f_left], pairs[2 * f_right]);
+        std::swap(pairs[2 * f_left + 1], pairs[2 * f_right + 1]);
+    };
+    auto siftDown = [&](uint32_t f_root, uint32_t f_size) {
+        while(true)
+        {
+            uint64_t child = 2 * static_cast<uint64_t>(f_root) + 1;
+            if(child >= f_size)
+            {
+                return;
+            }
+            if(child + 1 < f_size and less(child, child + 1))
+            {
+                child++;
+            }
+            if(not less(f_root, child))
+            {
+                return;
+            }
+            swapPairs(f_root, child);
+            f_root = child;
+        }
+    };
+
+    for(uint32_t root = numPairs / 2; root > 0; root--)
+    {
+        siftDown(root - 1, numPairs);
+    }
+    for(uint32_t size = numPairs; size > 1; size--)
+    {
+        swapPairs(0, size - 1);
+        siftDown(0, size - 1);
+    }
+    f_map.sortedKeys = true;
+}
+
+template<class T, class P>
+uint64_t GenericIndexedDecoder<T, P>::keyPrefix(const Entry & f_key) const
+{
+    P payloadPosition = f_key.end - f_key.numElements;
+    uint32_t prefixLength = f_key.numElements < 8 ? f_key.numElements : 8;
+    uint64_t prefix = 0;
+    for(uint32_t i = 0; i < prefixLength; i++)
+    {
+        prefix |= static_cast<uint64_t>(m_decoder.readRawByte(payloadPosition + i)) << (8 * (7 - i));
+    }
+    return prefix;
+}
+
+template<class T, class P>
+int GenericIndexedDecoder<T, P>::compareKey(const Entry & f_key, const char * f_string, size_t f_length) const
+{
+    if(f_key.numElements != f_length)
+    {
+        return f_key.numElements < f_length ? -1 : 1;
+    }
+    P payloadPosition = f_key.end - f_key.numElements;
+    for(size_t i = 0; i < f_length; i++)
+    {
+        uint8_t stored = m_decoder.readRawByte(payloadPosition + i);
+        uint8_t string = static_cast<uint8_t>(f_string[i]);
+        if(stored != string)
+        {
+            return stored < string ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+template<class T, class P>
+int GenericIndexedDecoder<T, P>::compareKeys(const Entry & f_left, const Entry & f_right) const
+{
+    if(f_left.numElements != f_right.numElements)
+    {
+        return f_left.numElements < f_right.numElements ? -1 : 1;
+    }
+    uint64_t leftPrefix = keyPrefix(f_left);
+    uint64_t rightPrefix = keyPrefix(f_right);
+    if(leftPrefix != rightPrefix)
+    {
+        return leftPrefix < rightPrefix ? -1 : 1;
+    }
+    P leftPayload = f_left.end - f_left.numElements;
+    P rightPayload = f_right.end - f_right.numElements;
+    for(uint32_t i = 8; i < f_left.numElements; i++)
+    {
+        uint8_t left = m_decoder.readRawByte(leftPayload + i);
+        uint8_t right = m_decoder.readRawByte(rightPayload + i);
+        if(left != right)
+        {
+            return left < right ? -1 : 1;
+        }
+    }
+    // duplicate keys: the first one in the message is found by operator[]
+    if(f_left.offset != f_right.offset)
+    {
+        return f_left.offset < f_right.offset ? -1 : 1;
+    }
+    return 0;
+}
+
+template<class T, class P>
+GenericIndexedDecoder<T, P> GenericIndexedDecoder<T, P>::operator[](const char * f_mapKey) const
+{
+    GenericIndexedDecoder newDecoder = *this;
+    newDecoder.m_valid = false;
+    if(not m_valid or m_entries[m_entry].headerType != HeaderInfo::Map)
+    {
+        return newDecoder;
+    }
+
+    const Entry & map = m_entries[m_entry];
+    size_t keyLength = strlen(f_mapKey);
+    if(map.sortedKeys)
+    {
+        // first pair with a key not less than f_mapKey
+        uint32_t first = 0;
+        uint32_t count = map.numElements;
+        while(count > 0)
+        {
+            uint32_t step = count / 2;
+            if(compareKey(m_entries[map.firstChild + 2 * (first + step)], f_mapKey, keyLength) < 0)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        P keyEntry = map.firstChild + 2 * first;
+        if(first < map.numElements and compareKey(m_entries[keyEntry], f_mapKey, keyLength) == 0)
+        {
+            newDecoder.m_entry = keyEntry + 1;
+            newDecoder.m_valid = true;
+        }
+        return newDecoder;
+    }
+
+    for(uint32_t elementNumber = 0; elementNumber < map.numElements; elementNumber++)
+    {
+        P keyEntry = map.firstChild + 2 * elementNumber;
+        const Entry & key = m_entries[keyEntry];
+        if(key.headerType != HeaderInfo::String)
+        {
+            // key could not be decoded...
+            return newDecoder;
+        }
+        if(key.numElements != keyLength)
+        {
+            continue;
+        }
+        Decoder keyDecoder = m_decoder;
+        keyDecoder.m_position = key.offset;
+        if(keyDecoder.compareString(f_mapKey, keyLength).get())
+        {
+            newDecoder.m_entry = keyEntry + 1;
+            newDecoder.m_valid = true;
+            return newDecoder;
+        }
+    }
+    return newDecoder;
+}
+
+template<class T, class P>
+GenericIndexedDecoder<T, P> GenericIndexedDecoder<T, P>::accessArray(uint32_t f_index) const
+{
+    GenericIndexedDecoder newDecoder = *this;
+    if(not m_valid or m_entries[m_entry].headerType != HeaderInfo::Array or f_index >= m_entries[m_entry].numElements)
+    {
+        newDecoder.m_valid = false;
+        return newDecoder;
+    }
+    newDecoder.m_entry = m_entries[m_entry].firstChild + f_index;
+    return newDecoder;
+}
+
+template<class T, class P>
+Maybe<uint32_t> GenericIndexedDecoder<T, P>::getMapSize() const
+{
+    if(not m_valid or m_entries[m_entry].headerType != HeaderInfo::Map)
+    {
+        return Maybe<uint32_t>();
+    }
+    return Maybe<uint32_t>(m_entries[m_entry].numElements);
+}
+
+template<class T, class P>
+Maybe<uint32_t> GenericIndexedDecoder<T, P>::getArraySize() const
+{
+    if(not m_valid or m_entries[m_entry].headerType != HeaderInfo::Array)
+    {
+        return Maybe<uint32_t>();
+    }
+    return Maybe<uint32_t>(m_entries[m_entry].numElements);
+}
+
+template<class T, class P>
+typename GenericIndexedDecoder<T, P>::Decoder GenericIndexedDecoder<T, P>::getDecoder() const
+{
+    Decoder decoder = m_decoder;
+    if(not m_valid)
+    {
+        decoder.m_validSeek = false;
+        return decoder;
+    }
+    decoder.m_position = m_entries[m_entry].offset;
+    return decoder;
+}
+
+}
@@ -0,0 +1,154 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <inttypes.h>
+#include "Decoder.hpp"
+
+namespace ZCMessagePack
+{
+/// Splits a stream of back to back messages (log files, pipes, ...) into
+/// single messages. Message boundaries are found with the same skip logic
+/// GenericDecoder uses, values are not decoded.
+///
+///     MessageSplitter splitter(buffer, bufferSize);
+///     while(not splitter.atEnd())
+///     {
+///         auto message = splitter.next();
+///         if(not message.isValid())
+///         {
+///             break; // malformed or truncated message at splitter.getPosition()
+///         }
+///         message["id"].getUint32();
+///     }
+template<class RawMessageReader, class PositionType = uint8_t>
+class GenericMessageSplitter
+{
+    public:
+        using Decoder = GenericDecoder<RawMessageReader, PositionType>;
+
+        GenericMessageSplitter(RawMessageReader f_raw_message_reader, PositionType f_streamSize) :
+            m_decoder(f_raw_message_reader, f_streamSize)
+        {
+        }
+
+        // Constructs a splitter using MemoryReader as the RawMessageReader.
+        template<typename U = RawMessageReader>
+        GenericMessageSplitter(const uint8_t * f_borrow_streamBuffer, PositionType f_streamSize, typename std::enable_if<std::is_same<U, MemoryReader>::value>::type* = 0) :
+            m_decoder(f_borrow_streamBuffer, f_streamSize)
+        {
+        }
+
+        /// True if all messages of the stream have been consumed.
+        bool atEnd() const
+        {
+            return m_decoder.m_position >= m_decoder.m_messageSize;
+        }
+
+        /// Offset of the next message in the stream.
+        PositionType getPosition() const
+        {
+            return m_decoder.m_position;
+        }
+
+        /// Returns a decoder for the next message and advances behind it.
+        /// The decoder can only access its own message.
+        /// NOTE: seekReset() on the returned decoder seeks to the start of
+        ///       the stream, not of the message.
+        /// If the stream is at its end or the next message is malformed or
+        /// truncated, an invalid decoder is returned and the position is not
+        /// changed (e.g. to retry after more data has been appended).
+        Decoder next();
+
+        /// Boundary-only scan: advances over all remaining messages and
+        /// calls f_callback(PositionType f_offset, PositionType f_size) for
+        /// each of them.
+        /// Stops at the end of the stream or at the first malformed message
+        /// (check atEnd() to tell).
+        /// @returns number of messages scanned
+        template<class Callback>
+        uint64_t scan(Callback && f_callback);
+
+        /// Same as scan(), without callback.
+        uint64_t countMessages()
+        {
+            return scan([](PositionType, PositionType) {});
+        }
+
+    private:
+        /// Returns the end of the message at current position, or the
+        /// current position if it is malformed.
+        PositionType findMessageEnd() const;
+
+        /// Positioned at the next message, m_messageSize is the stream size.
+        Decoder m_decoder;
+};
+
+// Convenience typedef for a GenericMessageSplitter using MemoryReader as the RawMessageReader.
+using MessageSplitter = GenericMessageSplitter<MemoryReader>;
+
+// Same as MessageSplitter, but able to handle streams bigger than 255 bytes.
+using LargeMessageSplitter = GenericMessageSplitter<MemoryReader, uint32_t>;
+
+template<class T, class P>
+P GenericMessageSplitter<T, P>::findMessageEnd() const
+{
+    if(atEnd())
+    {
+        return m_decoder.m_position;
+    }
+    Decoder cursor = m_decoder;
+    if(not cursor.skipElement())
+    {
+        return m_decoder.m_position;
+    }
+    return cursor.m_position;
+}
+
+template<class T, class P>
+typename GenericMessageSplitter<T, P>::Decoder GenericMessageSplitter<T, P>::next()
+{
+    Decoder message = m_decoder;
+    P end = findMessageEnd();
+    if(end == m_decoder.m_position)
+    {
+        message.m_validSeek = false;
+        return message;
+    }
+    message.m_messageSize = end;
+    m_decoder.m_position = end;
+    return message;
+}
+
+template<class T, class P>
+template<class Callback>
+uint64_t GenericMessageSplitter<T, P>::scan(Callback && f_callback)
+{
+    uint64_t numMessages = 0;
+    while(not atEnd())
+    {
+        P start = m_decoder.m_position;
+        P end = findMessageEnd();
+        if(end == start)
+        {
+            break;
+        }
+        f_callback(start, static_cast<P>(end - start));
+        m_decoder.m_position = end;
+        numMessages++;
+    }
+    return numMessages;
+}
+
+}
@@ -0,0 +1,228 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+// POSIX only (mmap/madvise).
+#include <inttypes.h>
+#include <stddef.h>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ZCMessagePack
+{
+/// RawMessageReader for a memory mapped file.
+/// Does not own the mapping (see MappedFile), so it is cheap to copy into
+/// decoders. Provides data(), so GenericDecoder accesses the mapping
+/// directly and the OS only pages in what is touched.
+class MmapReader
+{
+    public:
+    MmapReader() = default;
+
+    MmapReader(const uint8_t * f_mappedData) :
+        m_data(f_mappedData)
+    {
+    }
+
+    template<class PositionType>
+    void read(PositionType f_offset, PositionType f_size, uint8_t * f_out_buffer) const
+    {
+        std::memcpy(f_out_buffer, m_data + f_offset, f_size);
+    }
+
+    /// Direct access to the mapping (see HasContiguousData)
+    const uint8_t * data() const
+    {
+        return m_data;
+    }
+    private:
+    const uint8_t * m_data = nullptr;
+};
+
+/// Read-only memory mapping of a whole file.
+///
+///     MappedFile file("archive.msgpack");
+///     if(file.isValid())
+///     {
+///         GenericDecoder<MmapReader, uint64_t> decoder(file.getReader(), file.size());
+///     }
+///
+/// The mapping is released on destruction, so the MappedFile must outlive all
+/// decoders using its reader.
+class MappedFile
+{
+    public:
+        /// Hint about the expected access pattern, passed to madvise().
+        enum AccessPattern
+        {
+            Normal,
+            /// Lookups of single values (default): avoids large read-ahead.
+            Random,
+            /// Iterating over the whole message.
+            Sequential
+        };
+
+        /// Maps the given file. Check isValid() afterwards.
+        MappedFile(const char * f_path, AccessPattern f_accessPattern = Random);
+
+        ~MappedFile()
+        {
+            unmap();
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile && f_other) :
+            m_data(f_other.m_data),
+            m_size(f_other.m_size),
+            m_valid(f_other.m_valid)
+        {
+            f_other.release();
+        }
+
+        MappedFile & operator=(MappedFile && f_other)
+        {
+            if(this != &f_other)
+            {
+                unmap();
+                m_data = f_other.m_data;
+                m_size = f_other.m_size;
+                m_valid = f_other.m_valid;
+                f_other.release();
+            }
+            return *this;
+        }
+
+        /// True if the file could be opened and mapped.
+        /// Empty files are valid, but have no data.
+        bool isValid() const
+        {
+            return m_valid;
+        }
+
+        const uint8_t * data() const
+        {
+            return m_data;
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        MmapReader getReader() const
+        {
+            return MmapReader(m_data);
+        }
+
+        /// Changes the access pattern hint for the whole mapping.
+        bool advise(AccessPattern f_accessPattern);
+
+        /// Asks the OS to page in the given range ahead of use (MADV_WILLNEED),
+        /// e.g. a part of the message which is known to be accessed next.
+        bool prefetch(size_t f_offset, size_t f_size);
+
+    private:
+        void unmap()
+        {
+            if(m_data != nullptr)
+            {
+                munmap(const_cast<uint8_t *>(m_data), m_size);
+            }
+            release();
+        }
+
+        void release()
+        {
+            m_data = nullptr;
+            m_size = 0;
+            m_valid = false;
+        }
+
+        const uint8_t * m_data = nullptr;
+        size_t m_size = 0;
+        bool m_valid = false;
+};
+
+inline MappedFile::MappedFile(const char * f_path, AccessPattern f_accessPattern)
+{
+    int fd = open(f_path, O_RDONLY);
+    if(fd < 0)
+    {
+        return;
+    }
+    struct stat fileStatus;
+    if(fstat(fd, &fileStatus) != 0)
+    {
+        close(fd);
+        return;
+    }
+    m_size = fileStatus.st_size;
+    if(m_size == 0)
+    {
+        // mmap() does not accept empty mappings
+        close(fd);
+        m_valid = true;
+        return;
+    }
+    void * mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after closing the file
+    close(fd);
+    if(mapping == MAP_FAILED)
+    {
+        m_size = 0;
+        return;
+    }
+    m_data = static_cast<const uint8_t *>(mapping);
+    m_valid = true;
+    advise(f_accessPattern);
+}
+
+inline bool MappedFile::advise(AccessPattern f_accessPattern)
+{
+    if(m_data == nullptr)
+    {
+        return false;
+    }
+    int advice = MADV_NORMAL;
+    switch(f_accessPattern)
+    {
+        case Normal: advice = MADV_NORMAL; break;
+        case Random: advice = MADV_RANDOM; break;
+        case Sequential: advice = MADV_SEQUENTIAL; break;
+    }
+    return madvise(const_cast<uint8_t *>(m_data), m_size, advice) == 0;
+}
+
+inline bool MappedFile::prefetch(size_t f_offset, size_t f_size)
+{
+    if(m_data == nullptr or f_offset >= m_size)
+    {
+        return false;
+    }
+    if(f_size > m_size - f_offset)
+    {
+        f_size = m_size - f_offset;
+    }
+    // madvise() needs a page aligned start address
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t alignedOffset = f_offset - f_offset % pageSize;
+    return madvise(const_cast<uint8_t *>(m_data) + alignedOffset, f_size + (f_offset - alignedOffset), MADV_WILLNEED) == 0;
+}
+
+}
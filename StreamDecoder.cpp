@@ -0,0 +1,147 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "StreamDecoder.hpp"
+
+namespace ZCMessagePack
+{
+bool StreamDecoder::feed(const uint8_t * f_borrow_chunk, size_t f_chunkSize)
+{
+    if(chunkLeft() > 0)
+    {
+        return false;
+    }
+    m_chunk = f_borrow_chunk;
+    m_chunkSize = f_chunkSize;
+    m_chunkPosition = 0;
+    return true;
+}
+
+StreamDecoder::Status StreamDecoder::next()
+{
+    if(m_error)
+    {
+        return Error;
+    }
+
+    if(m_payloadLeft > 0)
+    {
+        if(chunkLeft() == 0)
+        {
+            return NeedMoreData;
+        }
+        uint32_t fragmentSize = chunkLeft() < m_payloadLeft ? chunkLeft() : m_payloadLeft;
+        m_fragment.data = m_chunk + m_chunkPosition;
+        m_fragment.size = fragmentSize;
+        m_chunkPosition += fragmentSize;
+        m_payloadLeft -= fragmentSize;
+        return PayloadFragment;
+    }
+
+    if(m_pendingSize == 0)
+    {
+        if(chunkLeft() == 0)
+        {
+            return NeedMoreData;
+        }
+        uint8_t size = elementSize(m_chunk[m_chunkPosition]);
+        if(size == 0)
+        {
+            m_error = true;
+            return Error;
+        }
+        if(chunkLeft() >= size)
+        {
+            // fast path: element is completely inside the chunk
+            m_element = m_chunk + m_chunkPosition;
+            m_elementSize = size;
+            m_chunkPosition += size;
+            return reportElement();
+        }
+    }
+
+    // element is split across chunks, collect it in m_pending
+    while(chunkLeft() > 0)
+    {
+        m_pending[m_pendingSize] = m_chunk[m_chunkPosition];
+        m_pendingSize++;
+        m_chunkPosition++;
+        uint8_t size = elementSize(m_pending[0]);
+        if(m_pendingSize == size)
+        {
+            m_element = m_pending;
+            m_elementSize = size;
+            m_pendingSize = 0;
+            return reportElement();
+        }
+    }
+    return NeedMoreData;
+}
+
+uint8_t StreamDecoder::elementSize(uint8_t f_typeCode)
+{
+    const TypeCodeInfo & info = typeCodeTable.entries[f_typeCode];
+    switch(info.headerType)
+    {
+        case HeaderInfo::InvalidHeader:
+            return 0;
+        case HeaderInfo::Map:
+        case HeaderInfo::Array:
+        case HeaderInfo::String:
+            // children/payload are reported separately
+            return info.headerSize;
+        default:
+            return info.headerSize + info.numPayloadElements;
+    }
+}
+
+StreamDecoder::Status StreamDecoder::reportElement()
+{
+    const TypeCodeInfo & info = typeCodeTable.entries[m_element[0]];
+    m_type = static_cast<HeaderInfo::HeaderType>(info.headerType);
+    uint32_t numElements = info.numPayloadElements;
+    if(m_type == HeaderInfo::Map or m_type == HeaderInfo::Array or m_type == HeaderInfo::String)
+    {
+        for(uint8_t i = 1; i < info.headerSize; i++)
+        {
+            numElements = (numElements << 8) | m_element[i];
+        }
+    }
+
+    if(m_remainingElements == 0)
+    {
+        // first element of a new message
+        m_remainingElements = 1;
+    }
+    m_remainingElements--;
+    m_payloadSize = 0;
+    switch(m_type)
+    {
+        case HeaderInfo::Map:
+            m_remainingElements += 2 * static_cast<uint64_t>(numElements);
+            break;
+        case HeaderInfo::Array:
+            m_remainingElements += numElements;
+            break;
+        case HeaderInfo::String:
+            m_payloadSize = numElements;
+            m_payloadLeft = numElements;
+            break;
+        default:
+            break;
+    }
+    return Element;
+}
+
+}
@@ -0,0 +1,145 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <inttypes.h>
+#include <stddef.h>
+#include "Decoder.hpp"
+
+namespace ZCMessagePack
+{
+/// Incremental pull decoder for messages arriving in chunks (e.g. from a socket).
+///
+/// Chunks are passed with feed(), elements are pulled with next() as soon as
+/// their bytes are available, so the whole message never needs to be buffered.
+/// Elements are reported in message order (maps: key, value, key, value, ...):
+///  - Element: a complete element header. For numbers, bool and nil also the
+///    value: getElement() returns a Decoder to read it.
+///    For maps and arrays getElement().getMapSize()/getArraySize() work, their
+///    children follow as separate elements.
+///    For strings and binary data only the header is included, the payload
+///    follows as PayloadFragment(s) (see getPayloadSize()).
+///  - PayloadFragment: the next part of a string/binary payload (getFragment()).
+///    Payloads are not copied, a fragment always lies within one chunk.
+///
+/// Multiple messages can be sent back to back, isMessageComplete() tells when
+/// the last element of a message was reported.
+///
+///     StreamDecoder stream;
+///     while(receive(chunk, &chunkSize))
+///     {
+///         stream.feed(chunk, chunkSize);
+///         StreamDecoder::Status status;
+///         while((status = stream.next()) != StreamDecoder::NeedMoreData)
+///         {
+///             ...
+///         }
+///     }
+class StreamDecoder
+{
+    public:
+        enum Status
+        {
+            /// Current chunk is consumed, feed() the next one.
+            NeedMoreData,
+            Element,
+            PayloadFragment,
+            /// Stream is malformed. Sticky until reset().
+            Error
+        };
+
+        StreamDecoder() = default;
+
+        /// Provides the next chunk of the stream.
+        /// The chunk must stay valid until next() returns NeedMoreData.
+        /// Returns false (and ignores the chunk) if the previous chunk is not
+        /// consumed yet.
+        bool feed(const uint8_t * f_borrow_chunk, size_t f_chunkSize);
+
+        /// Decodes the next element or payload fragment.
+        Status next();
+
+        /// Type of the last reported element.
+        HeaderInfo::HeaderType getType() const
+        {
+            return m_type;
+        }
+
+        /// Decoder for the last reported element.
+        /// Only valid until the next call of next() or feed().
+        Decoder getElement() const
+        {
+            return Decoder(m_element, m_elementSize);
+        }
+
+        /// Total payload size in bytes of the last reported string/binary element.
+        uint32_t getPayloadSize() const
+        {
+            return m_payloadSize;
+        }
+
+        /// Last reported payload fragment.
+        /// Only valid until the next call of next() or feed().
+        BinarySpan getFragment() const
+        {
+            return m_fragment;
+        }
+
+        /// True if the last reported element or fragment finished a message.
+        bool isMessageComplete() const
+        {
+            return m_remainingElements == 0 and m_payloadLeft == 0;
+        }
+
+        /// Drops all state, e.g. to recover from an error at a known message boundary.
+        void reset()
+        {
+            *this = StreamDecoder();
+        }
+
+    private:
+        /// Number of bytes needed to report an element with given type byte,
+        /// 0 for invalid type bytes.
+        static uint8_t elementSize(uint8_t f_typeCode);
+
+        /// Updates the message state for the complete element in m_element.
+        Status reportElement();
+
+        size_t chunkLeft() const
+        {
+            return m_chunkSize - m_chunkPosition;
+        }
+
+        const uint8_t * m_chunk = nullptr;
+        size_t m_chunkSize = 0;
+        size_t m_chunkPosition = 0;
+
+        /// Header bytes of an element split across chunks (at most 9 bytes:
+        /// type byte + 64 bit value).
+        uint8_t m_pending[9];
+        uint8_t m_pendingSize = 0;
+
+        const uint8_t * m_element = nullptr;
+        uint8_t m_elementSize = 0;
+        HeaderInfo::HeaderType m_type = HeaderInfo::InvalidHeader;
+
+        /// Elements still missing in the current message, 0 between messages.
+        uint64_t m_remainingElements = 0;
+        uint32_t m_payloadSize = 0;
+        uint32_t m_payloadLeft = 0;
+        BinarySpan m_fragment;
+        bool m_error = false;
+};
+
+}
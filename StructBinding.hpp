@@ -0,0 +1,301 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <inttypes.h>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "Decoder.hpp"
+#include "Encoder.hpp"
+
+namespace ZCMessagePack
+{
+/// Binds a map key to a struct member, see MessageFields.
+template<class Struct, class Member>
+struct Field
+{
+    const char * key;
+    Member Struct::* member;
+};
+
+template<class Struct, class Member>
+constexpr Field<Struct, Member> makeField(const char * f_key, Member Struct::* f_member)
+{
+    return Field<Struct, Member>{f_key, f_member};
+}
+
+/// Describes how a struct maps to a MessagePack map.
+/// Specialize it for every struct used with decodeInto()/encodeFrom():
+///
+///     struct Sensor { uint32_t id; char name[16]; double value; };
+///
+///     template<>
+///     struct ZCMessagePack::MessageFields<Sensor>
+///     {
+///         static constexpr auto fields = std::make_tuple(
+///                 makeField("id", &Sensor::id),
+///                 makeField("name", &Sensor::name),
+///                 makeField("value", &Sensor::value));
+///     };
+///
+/// Supported member types: bool, integers, float, double, char[N] (null
+/// terminated), std::string_view and BinarySpan (pointing into the message,
+/// contiguous readers only) and structs with MessageFields.
+template<class Struct>
+struct MessageFields;
+
+template<class Struct, class = void>
+struct HasMessageFields : std::false_type {};
+
+template<class Struct>
+struct HasMessageFields<Struct, std::void_t<decltype(MessageFields<Struct>::fields)>> : std::true_type {};
+
+template<class Struct>
+constexpr size_t numMessageFields()
+{
+    return std::tuple_size_v<std::decay_t<decltype(MessageFields<Struct>::fields)>>;
+}
+
+template<class Struct, class RawMessageReader, class PositionType, class Instrumentation>
+Maybe<uint64_t> decodeInto(const GenericDecoder<RawMessageReader, PositionType, Instrumentation> & f_decoder, Struct & f_out_struct);
+
+template<class Struct, class PositionType>
+bool encodeFrom(GenericEncoder<PositionType> & f_encoder, const Struct & f_struct);
+
+template<class Value, class Member>
+bool assignIfValid(Maybe<Value> f_value, Member & f_out_member)
+{
+    if(not f_value.isValid())
+    {
+        return false;
+    }
+    f_out_member = f_value.get();
+    return true;
+}
+
+/// Decodes a single value into a member of given type.
+/// @returns false on type mismatch (member is not modified)
+template<class RawMessageReader, class PositionType, class Instrumentation, class Member>
+bool decodeMember(const GenericDecoder<RawMessageReader, PositionType, Instrumentation> & f_decoder, Member & f_out_member)
+{
+    if constexpr(std::is_same_v<Member, bool>)
+    {
+        return assignIfValid(f_decoder.getBool(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, uint8_t>)
+    {
+        return assignIfValid(f_decoder.getUint8(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, uint16_t>)
+    {
+        return assignIfValid(f_decoder.getUint16(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, uint32_t>)
+    {
+        return assignIfValid(f_decoder.getUint32(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, uint64_t>)
+    {
+        return assignIfValid(f_decoder.getUint64(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, int8_t>)
+    {
+        return assignIfValid(f_decoder.getInt8(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, int16_t>)
+    {
+        return assignIfValid(f_decoder.getInt16(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, int32_t>)
+    {
+        return assignIfValid(f_decoder.getInt32(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, int64_t>)
+    {
+        return assignIfValid(f_decoder.getInt64(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, float>)
+    {
+        return assignIfValid(f_decoder.getFloat(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, double>)
+    {
+        return assignIfValid(f_decoder.getDouble(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, std::string_view>)
+    {
+        return assignIfValid(f_decoder.getStringView(), f_out_member);
+    }
+    else if constexpr(std::is_same_v<Member, BinarySpan>)
+    {
+        return assignIfValid(f_decoder.getBinarySpan(), f_out_member);
+    }
+    else if constexpr(std::is_array_v<Member> and std::is_same_v<std::remove_extent_t<Member>, char>)
+    {
+        constexpr size_t maxSize = std::extent_v<Member> < std::numeric_limits<PositionType>::max() ?
+            std::extent_v<Member> : std::numeric_limits<PositionType>::max();
+        // getString() clears its buffer on failure, the member must stay untouched
+        char decoded[maxSize];
+        auto length = f_decoder.getString(decoded, maxSize);
+        if(not length.isValid())
+        {
+            return false;
+        }
+        std::memcpy(f_out_member, decoded, length.get() + 1);
+        return true;
+    }
+    else
+    {
+        static_assert(HasMessageFields<Member>::value, "unsupported member type, specialize MessageFields<> for structs");
+        // decodeInto() writes fields one by one, a struct missing fields
+        // must not be left half overwritten
+        Member decoded = f_out_member;
+        auto missing = decodeInto(f_decoder, decoded);
+        if(not missing.isValid() or missing.get() != 0)
+        {
+            return false;
+        }
+        f_out_member = decoded;
+        return true;
+    }
+}
+
+/// Encodes a single member of given type.
+template<class PositionType, class Member>
+bool encodeMember(GenericEncoder<PositionType> & f_encoder, const Member & f_member)
+{
+    if constexpr(std::is_same_v<Member, bool>)
+    {
+        return f_encoder.addBool(f_member);
+    }
+    else if constexpr(std::is_integral_v<Member> and std::is_unsigned_v<Member>)
+    {
+        return f_encoder.addUint(f_member);
+    }
+    else if constexpr(std::is_integral_v<Member>)
+    {
+        return f_encoder.addInt(f_member);
+    }
+    else if constexpr(std::is_same_v<Member, float>)
+    {
+        return f_encoder.addFloat(f_member);
+    }
+    else if constexpr(std::is_same_v<Member, double>)
+    {
+        return f_encoder.addDouble(f_member);
+    }
+    else if constexpr(std::is_same_v<Member, std::string_view>)
+    {
+        return f_member.size() <= std::numeric_limits<PositionType>::max() and f_encoder.addString(f_member.data(), f_member.size());
+    }
+    else if constexpr(std::is_same_v<Member, BinarySpan>)
+    {
+        return f_member.size <= std::numeric_limits<PositionType>::max() and f_encoder.addBinary(f_member.data, f_member.size);
+    }
+    else if constexpr(std::is_array_v<Member> and std::is_same_v<std::remove_extent_t<Member>, char>)
+    {
+        // does not read behind the array, even if it is not null terminated
+        return f_encoder.addString(f_member, strnlen(f_member, std::extent_v<Member>));
+    }
+    else
+    {
+        static_assert(HasMessageFields<Member>::value, "unsupported member type, specialize MessageFields<> for structs");
+        return encodeFrom(f_encoder, f_member);
+    }
+}
+
+/// Decodes the map entry f_entry into field Index, if its key matches.
+/// @returns true if the key matched
+template<size_t Index, class Struct, class MapEntry>
+bool decodeFieldIfMatching(const MapEntry & f_entry, Struct & f_out_struct, uint64_t & f_missingFields)
+{
+    const auto & field = std::get<Index>(MessageFields<Struct>::fields);
+    uint64_t fieldBit = static_cast<uint64_t>(1) << Index;
+    if((f_missingFields & fieldBit) == 0)
+    {
+        // already decoded (duplicate keys: first one wins)
+        return false;
+    }
+    auto match = f_entry.key.compareString(field.key);
+    if(not match.isValid() or not match.get())
+    {
+        return false;
+    }
+    if(decodeMember(f_entry.value, f_out_struct.*(field.member)))
+    {
+        f_missingFields &= ~fieldBit;
+    }
+    return true;
+}
+
+template<class Struct, class MapEntry, size_t... Index>
+void decodeFields(const MapEntry & f_entry, Struct & f_out_struct, uint64_t & f_missingFields, std::index_sequence<Index...>)
+{
+    // stops at the first matching field
+    (decodeFieldIfMatching<Index>(f_entry, f_out_struct, f_missingFields) or ...);
+}
+
+/// Decodes the map at the current position of f_decoder into f_out_struct,
+/// walking the map exactly once. Keys without a field are ignored.
+/// @returns bit mask of fields (in MessageFields order) which were missing or
+///          could not be decoded into their member type, 0 if all fields
+///          were decoded. Invalid if f_decoder does not refer to a
+///          (well formed) map.
+template<class Struct, class RawMessageReader, class PositionType, class Instrumentation>
+Maybe<uint64_t> decodeInto(const GenericDecoder<RawMessageReader, PositionType, Instrumentation> & f_decoder, Struct & f_out_struct)
+{
+    constexpr size_t numFields = numMessageFields<Struct>();
+    static_assert(numFields <= 64, "at most 64 fields are supported");
+    auto mapSize = f_decoder.getMapSize();
+    if(not mapSize.isValid())
+    {
+        return Maybe<uint64_t>();
+    }
+
+    uint64_t missingFields = numFields == 64 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << numFields) - 1;
+    uint32_t numEntries = 0;
+    for(auto & entry : f_decoder.getMapEntries())
+    {
+        decodeFields(entry, f_out_struct, missingFields, std::make_index_sequence<numFields>());
+        numEntries++;
+    }
+    if(numEntries != mapSize.get())
+    {
+        // iteration stopped at a malformed entry
+        return Maybe<uint64_t>();
+    }
+    return Maybe<uint64_t>(missingFields);
+}
+
+template<class Struct, class PositionType, size_t... Index>
+bool encodeFields(GenericEncoder<PositionType> & f_encoder, const Struct & f_struct, std::index_sequence<Index...>)
+{
+    return ((f_encoder.addString(std::get<Index>(MessageFields<Struct>::fields).key)
+                and encodeMember(f_encoder, f_struct.*(std::get<Index>(MessageFields<Struct>::fields).member))) and ...);
+}
+
+/// Encodes f_struct as a map containing all fields of MessageFields<Struct>.
+/// @returns false if the buffer is too small
+template<class Struct, class PositionType>
+bool encodeFrom(GenericEncoder<PositionType> & f_encoder, const Struct & f_struct)
+{
+    constexpr size_t numFields = numMessageFields<Struct>();
+    return f_encoder.addMap(numFields) and encodeFields(f_encoder, f_struct, std::make_index_sequence<numFields>());
+}
+
+}
@@ -0,0 +1,144 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Minimal self-contained benchmark harness (modeled after Google Benchmark):
+//
+//     static void benchSomething(Benchmark::State & f_state)
+//     {
+//         // setup
+//         while(f_state.keepRunning())
+//         {
+//             Benchmark::doNotOptimize(operation());
+//         }
+//         f_state.setBytesPerIteration(size);
+//     }
+//     BENCHMARK(benchSomething);
+//     BENCHMARK_ARG(benchSomething, 16); // f_state.getArg() == 16
+//
+// Only the measured loop is timed (setup before and after it is not).
+// Iterations are increased until a run takes long enough for a stable
+// measurement. Results are reported as ns/op and (optionally) bytes/s.
+
+#pragma once
+#include <inttypes.h>
+#include <stddef.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+class State
+{
+    public:
+        State(uint64_t f_iterations, int64_t f_arg) :
+            m_iterations(f_iterations),
+            m_remaining(f_iterations),
+            m_arg(f_arg)
+        {
+        }
+
+        /// Loop condition of the measured loop. The timer starts with the
+        /// first call and stops when it returns false.
+        bool keepRunning()
+        {
+            if(m_remaining == m_iterations)
+            {
+                m_start = std::chrono::steady_clock::now();
+            }
+            if(m_remaining == 0)
+            {
+                m_end = std::chrono::steady_clock::now();
+                return false;
+            }
+            m_remaining--;
+            return true;
+        }
+
+        /// Duration of the measured loop.
+        double getElapsedNs() const
+        {
+            return std::chrono::duration<double, std::nano>(m_end - m_start).count();
+        }
+
+        int64_t getArg() const
+        {
+            return m_arg;
+        }
+
+        uint64_t getIterations() const
+        {
+            return m_iterations;
+        }
+
+        /// Number of bytes processed by one iteration, enables the bytes/s column.
+        void setBytesPerIteration(uint64_t f_bytes)
+        {
+            m_bytesPerIteration = f_bytes;
+        }
+
+        uint64_t getBytesPerIteration() const
+        {
+            return m_bytesPerIteration;
+        }
+
+    private:
+        uint64_t m_iterations;
+        uint64_t m_remaining;
+        int64_t m_arg;
+        uint64_t m_bytesPerIteration = 0;
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::steady_clock::time_point m_end;
+};
+
+using Function = void (*)(State & f_state);
+
+struct Registration
+{
+    std::string name;
+    Function function;
+    int64_t arg;
+    bool hasArg;
+};
+
+std::vector<Registration> & registry();
+
+inline int registerBenchmark(const char * f_name, Function f_function, int64_t f_arg, bool f_hasArg)
+{
+    registry().push_back(Registration{f_name, f_function, f_arg, f_hasArg});
+    return 0;
+}
+
+/// Runs all benchmarks whose name contains f_filter (all if empty).
+void runAll(const std::string & f_filter);
+
+/// Keeps the compiler from optimizing away the computation of f_value.
+template<class T>
+inline void doNotOptimize(const T & f_value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(f_value) : "memory");
+#else
+    static volatile const void * sink;
+    sink = &f_value;
+#endif
+}
+}
+
+#define BENCHMARK_CONCAT_(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_(a, b)
+#define BENCHMARK(function) \
+    static int BENCHMARK_CONCAT(benchmarkRegistration, __LINE__) = Benchmark::registerBenchmark(#function, function, 0, false)
+#define BENCHMARK_ARG(function, arg) \
+    static int BENCHMARK_CONCAT(benchmarkRegistration, __LINE__) = Benchmark::registerBenchmark(#function, function, arg, true)
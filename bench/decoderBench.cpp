@@ -0,0 +1,330 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Decoder access patterns:
+//  - decodeHeader(): cost of a single header via isNil() on varying types
+//  - seekElementByKey(): last key of maps of varying size, nested maps of
+//    varying depth
+//  - accessArray(): varying indices
+//  - string/binary extraction (copy and zero copy)
+
+#include "Benchmark.hpp"
+#include "Decoder.hpp"
+#include "Encoder.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace ZCMessagePack;
+
+// argument: type code of the decoded element
+static void benchDecodeHeader(Benchmark::State & f_state)
+{
+    uint8_t message[9] = {static_cast<uint8_t>(f_state.getArg()), 0, 0, 0, 0, 0, 0, 0, 1};
+    LargeDecoder decoder(message, sizeof(message));
+    while(f_state.keepRunning())
+    {
+        Benchmark::doNotOptimize(decoder.isNil());
+    }
+}
+BENCHMARK_ARG(benchDecodeHeader, 0x05); // positive fixint
+BENCHMARK_ARG(benchDecodeHeader, 0xc0); // nil
+BENCHMARK_ARG(benchDecodeHeader, 0xcd); // uint16
+BENCHMARK_ARG(benchDecodeHeader, 0xdc); // array16
+
+static void benchGetUint32(Benchmark::State & f_state)
+{
+    uint8_t message[5] = {0xce, 0x12, 0x34, 0x56, 0x78};
+    LargeDecoder decoder(message, sizeof(message));
+    while(f_state.keepRunning())
+    {
+        Benchmark::doNotOptimize(decoder.getUint32());
+    }
+}
+BENCHMARK(benchGetUint32);
+
+// isNil() followed by a typed access: decodes the header twice
+static void benchNilCheckDecoder(Benchmark::State & f_state)
+{
+    uint8_t message[5] = {0xce, 0x12, 0x34, 0x56, 0x78};
+    LargeDecoder decoder(message, sizeof(message));
+    while(f_state.keepRunning())
+    {
+        if(not decoder.isNil().get())
+        {
+            Benchmark::doNotOptimize(decoder.get<uint32_t>());
+        }
+    }
+}
+BENCHMARK(benchNilCheckDecoder);
+
+// same as benchNilCheckDecoder, using a Value (one header decode)
+static void benchNilCheckValue(Benchmark::State & f_state)
+{
+    uint8_t message[5] = {0xce, 0x12, 0x34, 0x56, 0x78};
+    LargeDecoder decoder(message, sizeof(message));
+    while(f_state.keepRunning())
+    {
+        auto value = decoder.getValue();
+        if(not value.isNil())
+        {
+            Benchmark::doNotOptimize(value.get<uint32_t>());
+        }
+    }
+}
+BENCHMARK(benchNilCheckValue);
+
+static std::vector<uint8_t> payloadMessage(uint32_t f_size, bool f_binary)
+{
+    std::vector<uint8_t> message(f_size + 5);
+    LargeEncoder encoder(message.data(), message.size());
+    std::vector<uint8_t> payload(f_size, 'x');
+    if(f_binary)
+    {
+        encoder.addBinary(payload.data(), payload.size());
+    }
+    else
+    {
+        encoder.addString(reinterpret_cast<const char *>(payload.data()), payload.size());
+    }
+    message.resize(encoder.getMessageSize());
+    return message;
+}
+
+static std::string keyName(uint32_t f_index)
+{
+    return "key" + std::to_string(f_index);
+}
+
+// argument: number of map entries, the last key is looked up
+static void benchSeekKeyMapSize(Benchmark::State & f_state)
+{
+    uint32_t mapSize = f_state.getArg();
+    std::vector<uint8_t> message(mapSize * 16 + 16);
+    LargeEncoder encoder(message.data(), message.size());
+    encoder.addMap(mapSize);
+    for(uint32_t i = 0; i < mapSize; i++)
+    {
+        encoder.addString(keyName(i).c_str());
+        encoder.addUint(i);
+    }
+    LargeDecoder decoder(message.data(), encoder.getMessageSize());
+    std::string lastKey = keyName(mapSize - 1);
+
+    while(f_state.keepRunning())
+    {
+        LargeDecoder cursor = decoder;
+        cursor.seekElementByKey(lastKey.c_str(), lastKey.size());
+        Benchmark::doNotOptimize(cursor.getUint32());
+    }
+    f_state.setBytesPerIteration(encoder.getMessageSize());
+}
+BENCHMARK_ARG(benchSeekKeyMapSize, 1);
+BENCHMARK_ARG(benchSeekKeyMapSize, 8);
+BENCHMARK_ARG(benchSeekKeyMapSize, 64);
+BENCHMARK_ARG(benchSeekKeyMapSize, 1024);
+
+// same as benchSeekKeyMapSize, with a precomputed Key
+static void benchSeekPrecomputedKey(Benchmark::State & f_state)
+{
+    uint32_t mapSize = f_state.getArg();
+    std::vector<uint8_t> message(mapSize * 16 + 16);
+    LargeEncoder encoder(message.data(), message.size());
+    encoder.addMap(mapSize);
+    for(uint32_t i = 0; i < mapSize; i++)
+    {
+        encoder.addString(keyName(i).c_str());
+        encoder.addUint(i);
+    }
+    LargeDecoder decoder(message.data(), encoder.getMessageSize());
+    std::string lastKeyName = keyName(mapSize - 1);
+    Key lastKey(lastKeyName.c_str());
+
+    while(f_state.keepRunning())
+    {
+        Benchmark::doNotOptimize(decoder[lastKey].getUint32());
+    }
+    f_state.setBytesPerIteration(encoder.getMessageSize());
+}
+BENCHMARK_ARG(benchSeekPrecomputedKey, 1);
+BENCHMARK_ARG(benchSeekPrecomputedKey, 8);
+BENCHMARK_ARG(benchSeekPrecomputedKey, 64);
+BENCHMARK_ARG(benchSeekPrecomputedKey, 1024);
+
+// argument: key length, keys differ in their last byte only
+static void benchSeekKeyLength(Benchmark::State & f_state)
+{
+    const uint32_t mapSize = 16;
+    uint32_t keyLength = f_state.getArg();
+    std::vector<uint8_t> message(mapSize * (keyLength + 8) + 16);
+    LargeEncoder encoder(message.data(), message.size());
+    encoder.addMap(mapSize);
+    std::string key(keyLength, 'k');
+    for(uint32_t i = 0; i < mapSize; i++)
+    {
+        key.back() = 'a' + i;
+        encoder.addString(key.c_str());
+        encoder.addUint(i);
+    }
+    LargeDecoder decoder(message.data(), encoder.getMessageSize());
+
+    while(f_state.keepRunning())
+    {
+        LargeDecoder cursor = decoder;
+        cursor.seekElementByKey(key.c_str(), key.size());
+        Benchmark::doNotOptimize(cursor.getUint32());
+    }
+    f_state.setBytesPerIteration(encoder.getMessageSize());
+}
+BENCHMARK_ARG(benchSeekKeyLength, 4);
+BENCHMARK_ARG(benchSeekKeyLength, 12);
+BENCHMARK_ARG(benchSeekKeyLength, 32);
+
+// argument: string length, compared against an equal string
+static void benchCompareString(Benchmark::State & f_state)
+{
+    std::string string(f_state.getArg(), 'x');
+    std::vector<uint8_t> message = payloadMessage(string.size(), false);
+    LargeDecoder decoder(message.data(), message.size());
+    while(f_state.keepRunning())
+    {
+        Benchmark::doNotOptimize(decoder.compareString(string.c_str()));
+    }
+    f_state.setBytesPerIteration(string.size());
+}
+BENCHMARK_ARG(benchCompareString, 4);
+BENCHMARK_ARG(benchCompareString, 16);
+BENCHMARK_ARG(benchCompareString, 40);
+
+// argument: nesting depth of maps {"padding": 0, "child": {...}}
+static void benchSeekKeyDepth(Benchmark::State & f_state)
+{
+    uint32_t depth = f_state.getArg();
+    std::vector<uint8_t> message(depth * 32 + 16);
+    LargeEncoder encoder(message.data(), message.size());
+    for(uint32_t i = 0; i < depth; i++)
+    {
+        encoder.addMap(2);
+        encoder.addString("padding");
+        encoder.addUint(i);
+        encoder.addString("child");
+    }
+    encoder.addUint(42);
+    LargeDecoder decoder(message.data(), encoder.getMessageSize());
+
+    while(f_state.keepRunning())
+    {
+        LargeDecoder cursor = decoder;
+        for(uint32_t i = 0; i < depth; i++)
+        {
+            cursor.seekElementByKey("child", 5);
+        }
+        Benchmark::doNotOptimize(cursor.getUint8());
+    }
+    f_state.setBytesPerIteration(encoder.getMessageSize());
+}
+BENCHMARK_ARG(benchSeekKeyDepth, 1);
+BENCHMARK_ARG(benchSeekKeyDepth, 4);
+BENCHMARK_ARG(benchSeekKeyDepth, 16);
+BENCHMARK_ARG(benchSeekKeyDepth, 64);
+
+// argument: accessed index of an array of 4096 mixed width integers
+static void benchAccessArray(Benchmark::State & f_state)
+{
+    const uint32_t arraySize = 4096;
+    std::vector<uint8_t> message(arraySize * 5 + 8);
+    LargeEncoder encoder(message.data(), message.size());
+    encoder.addArray(arraySize);
+    for(uint32_t i = 0; i < arraySize; i++)
+    {
+        encoder.addUint(i * 37);
+    }
+    LargeDecoder decoder(message.data(), encoder.getMessageSize());
+    uint32_t index = f_state.getArg();
+
+    while(f_state.keepRunning())
+    {
+        Benchmark::doNotOptimize(decoder.accessArray(index).getUint32());
+    }
+}
+BENCHMARK_ARG(benchAccessArray, 0);
+BENCHMARK_ARG(benchAccessArray, 16);
+BENCHMARK_ARG(benchAccessArray, 256);
+BENCHMARK_ARG(benchAccessArray, 4095);
+
+// argument: string length
+static void benchGetString(Benchmark::State & f_state)
+{
+    uint32_t size = f_state.getArg();
+    std::vector<uint8_t> message = payloadMessage(size, false);
+    LargeDecoder decoder(message.data(), message.size());
+    std::vector<char> output(size + 1);
+    while(f_state.keepRunning())
+    {
+        Benchmark::doNotOptimize(decoder.getString(output.data(), output.size()));
+        Benchmark::doNotOptimize(output.data());
+    }
+    f_state.setBytesPerIteration(size);
+}
+BENCHMARK_ARG(benchGetString, 8);
+BENCHMARK_ARG(benchGetString, 256);
+BENCHMARK_ARG(benchGetString, 65536);
+
+// argument: string length
+static void benchGetStringView(Benchmark::State & f_state)
+{
+    uint32_t size = f_state.getArg();
+    std::vector<uint8_t> message = payloadMessage(size, false);
+    LargeDecoder decoder(message.data(), message.size());
+    while(f_state.keepRunning())
+    {
+        Benchmark::doNotOptimize(decoder.getStringView());
+    }
+    f_state.setBytesPerIteration(size);
+}
+BENCHMARK_ARG(benchGetStringView, 8);
+BENCHMARK_ARG(benchGetStringView, 65536);
+
+// argument: binary size
+static void benchGetBinary(Benchmark::State & f_state)
+{
+    uint32_t size = f_state.getArg();
+    std::vector<uint8_t> message = payloadMessage(size, true);
+    LargeDecoder decoder(message.data(), message.size());
+    std::vector<uint8_t> output(size);
+    while(f_state.keepRunning())
+    {
+        Benchmark::doNotOptimize(decoder.getBinary(output.data(), output.size()));
+        Benchmark::doNotOptimize(output.data());
+    }
+    f_state.setBytesPerIteration(size);
+}
+BENCHMARK_ARG(benchGetBinary, 8);
+BENCHMARK_ARG(benchGetBinary, 256);
+BENCHMARK_ARG(benchGetBinary, 65536);
+
+// argument: binary size
+static void benchGetBinarySpan(Benchmark::State & f_state)
+{
+    uint32_t size = f_state.getArg();
+    std::vector<uint8_t> message = payloadMessage(size, true);
+    LargeDecoder decoder(message.data(), message.size());
+    while(f_state.keepRunning())
+    {
+        Benchmark::doNotOptimize(decoder.getBinarySpan());
+    }
+    f_state.setBytesPerIteration(size);
+}
+BENCHMARK_ARG(benchGetBinarySpan, 8);
+BENCHMARK_ARG(benchGetBinarySpan, 65536);
@@ -0,0 +1,103 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Encoder::add*() throughput. Each iteration encodes a fixed sequence of
+// values into a reused buffer, bytes/s refers to the encoded output.
+
+#include "Benchmark.hpp"
+#include "Encoder.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace ZCMessagePack;
+
+static const uint32_t numValues = 256;
+
+template<class AddFunction>
+static void runEncoder(Benchmark::State & f_state, size_t f_bufferSize, AddFunction f_add)
+{
+    std::vector<uint8_t> buffer(f_bufferSize);
+    uint32_t messageSize = 0;
+    while(f_state.keepRunning())
+    {
+        LargeEncoder encoder(buffer.data(), buffer.size());
+        for(uint32_t i = 0; i < numValues; i++)
+        {
+            f_add(encoder, i);
+        }
+        messageSize = encoder.getMessageSize();
+        Benchmark::doNotOptimize(buffer.data());
+    }
+    f_state.setBytesPerIteration(messageSize);
+}
+
+static void benchAddUintSmall(Benchmark::State & f_state)
+{
+    runEncoder(f_state, numValues, [](LargeEncoder & f_encoder, uint32_t f_i) { f_encoder.addUint(f_i & 0x7f); });
+}
+BENCHMARK(benchAddUintSmall);
+
+static void benchAddUint64(Benchmark::State & f_state)
+{
+    runEncoder(f_state, numValues * 9, [](LargeEncoder & f_encoder, uint32_t f_i) { f_encoder.addUint(0x100000000ull + f_i); });
+}
+BENCHMARK(benchAddUint64);
+
+static void benchAddInt(Benchmark::State & f_state)
+{
+    runEncoder(f_state, numValues * 3, [](LargeEncoder & f_encoder, uint32_t f_i) { f_encoder.addInt(-1000 - static_cast<int64_t>(f_i)); });
+}
+BENCHMARK(benchAddInt);
+
+static void benchAddDouble(Benchmark::State & f_state)
+{
+    runEncoder(f_state, numValues * 9, [](LargeEncoder & f_encoder, uint32_t f_i) { f_encoder.addDouble(f_i * 0.5); });
+}
+BENCHMARK(benchAddDouble);
+
+static void benchAddBool(Benchmark::State & f_state)
+{
+    runEncoder(f_state, numValues, [](LargeEncoder & f_encoder, uint32_t f_i) { f_encoder.addBool(f_i & 1); });
+}
+BENCHMARK(benchAddBool);
+
+static void benchAddMapHeader(Benchmark::State & f_state)
+{
+    runEncoder(f_state, numValues * 3, [](LargeEncoder & f_encoder, uint32_t f_i) { f_encoder.addMap(f_i * 4); });
+}
+BENCHMARK(benchAddMapHeader);
+
+// argument: string length
+static void benchAddString(Benchmark::State & f_state)
+{
+    std::string value(f_state.getArg(), 'x');
+    runEncoder(f_state, numValues * (value.size() + 5), [&](LargeEncoder & f_encoder, uint32_t) {
+        f_encoder.addString(value.c_str(), value.size());
+    });
+}
+BENCHMARK_ARG(benchAddString, 8);
+BENCHMARK_ARG(benchAddString, 64);
+BENCHMARK_ARG(benchAddString, 1024);
+
+// argument: binary size
+static void benchAddBinary(Benchmark::State & f_state)
+{
+    std::vector<uint8_t> value(f_state.getArg(), 0x55);
+    runEncoder(f_state, numValues * (value.size() + 5), [&](LargeEncoder & f_encoder, uint32_t) {
+        f_encoder.addBinary(value.data(), value.size());
+    });
+}
+BENCHMARK_ARG(benchAddBinary, 8);
+BENCHMARK_ARG(benchAddBinary, 1024);
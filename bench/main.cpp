@@ -0,0 +1,78 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Benchmark.hpp"
+
+#include <cstdio>
+
+namespace Benchmark
+{
+std::vector<Registration> & registry()
+{
+    static std::vector<Registration> benchmarks;
+    return benchmarks;
+}
+
+static double runNs(const Registration & f_benchmark, uint64_t f_iterations, uint64_t & f_out_bytesPerIteration)
+{
+    State state(f_iterations, f_benchmark.arg);
+    f_benchmark.function(state);
+    f_out_bytesPerIteration = state.getBytesPerIteration();
+    return state.getElapsedNs();
+}
+
+void runAll(const std::string & f_filter)
+{
+    const double minRunNs = 200e6;
+    printf("%-40s %14s %12s %14s\n", "Benchmark", "Iterations", "ns/op", "MB/s");
+    for(const Registration & benchmark : registry())
+    {
+        std::string name = benchmark.name;
+        if(benchmark.hasArg)
+        {
+            name += "/" + std::to_string(benchmark.arg);
+        }
+        if(name.find(f_filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        // grow the iteration count until the run is long enough
+        uint64_t iterations = 1;
+        uint64_t bytesPerIteration = 0;
+        double ns = runNs(benchmark, iterations, bytesPerIteration);
+        while(ns < minRunNs and iterations < (1ull << 40))
+        {
+            double factor = ns > 0 ? 1.4 * minRunNs / ns : 100;
+            factor = factor > 100 ? 100 : (factor < 2 ? 2 : factor);
+            iterations *= factor;
+            ns = runNs(benchmark, iterations, bytesPerIteration);
+        }
+
+        double nsPerOp = ns / iterations;
+        printf("%-40s %14llu %12.2f", name.c_str(), static_cast<unsigned long long>(iterations), nsPerOp);
+        if(bytesPerIteration > 0)
+        {
+            printf(" %14.1f", bytesPerIteration / nsPerOp * 1e9 / 1e6);
+        }
+        printf("\n");
+    }
+}
+}
+
+int main(int argc, char ** argv)
+{
+    Benchmark::runAll(argc > 1 ? argv[1] : "");
+    return 0;
+}
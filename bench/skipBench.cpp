@@ -0,0 +1,92 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Skip-heavy workloads, dominated by decodeHeader():
+//  - "records": accessing the last element of an array of identical maps
+//    (regular type sequence, branch friendly)
+//  - "mixed": iterating an array of randomly chosen element types
+
+#include "Benchmark.hpp"
+#include "Decoder.hpp"
+#include "Encoder.hpp"
+
+#include <vector>
+
+using namespace ZCMessagePack;
+
+static void benchSkipRecords(Benchmark::State & f_state)
+{
+    const uint8_t numElements = 250;
+    std::vector<uint8_t> message(16 * 1024);
+    LargeEncoder encoder(message.data(), message.size());
+    encoder.addArray(numElements);
+    for(uint8_t i = 0; i < numElements - 1; i++)
+    {
+        // 11 headers per record
+        encoder.addMap(3);
+        encoder.addString("id");
+        encoder.addUint(i * 1000);
+        encoder.addString("name");
+        encoder.addString("some sensor name");
+        encoder.addString("values");
+        encoder.addArray(4);
+        encoder.addBool(true);
+        encoder.addNil();
+        encoder.addInt(-5);
+        encoder.addUint(200);
+    }
+    encoder.addUint(42);
+    LargeDecoder decoder(message.data(), encoder.getMessageSize());
+
+    while(f_state.keepRunning())
+    {
+        Benchmark::doNotOptimize(decoder.accessArray(numElements - 1).getUint8());
+    }
+    f_state.setBytesPerIteration(encoder.getMessageSize());
+}
+BENCHMARK(benchSkipRecords);
+
+static void benchSkipMixed(Benchmark::State & f_state)
+{
+    const uint16_t numElements = 60000;
+    std::vector<uint8_t> message{{0xdc, numElements >> 8, numElements & 0xff}};
+    uint32_t seed = 1;
+    for(uint16_t i = 0; i < numElements; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        switch((seed >> 16) % 7)
+        {
+            case 0: message.insert(message.end(), {0x05}); break;
+            case 1: message.insert(message.end(), {0xcd, 0x01, 0x02}); break;
+            case 2: message.insert(message.end(), {0xa3, 'a', 'b', 'c'}); break;
+            case 3: message.insert(message.end(), {0xc3}); break;
+            case 4: message.insert(message.end(), {0xc0}); break;
+            case 5: message.insert(message.end(), {0xd0, 0xfd}); break;
+            case 6: message.insert(message.end(), {0x92, 0x01, 0xa1, 'x'}); break;
+        }
+    }
+    LargeDecoder decoder(message.data(), message.size());
+
+    while(f_state.keepRunning())
+    {
+        uint32_t numIntegers = 0;
+        for(auto & element : decoder.getArrayElements())
+        {
+            numIntegers += element.getUint8().isValid();
+        }
+        Benchmark::doNotOptimize(numIntegers);
+    }
+    f_state.setBytesPerIteration(message.size());
+}
+BENCHMARK(benchSkipMixed);
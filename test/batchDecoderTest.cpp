@@ -0,0 +1,123 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "BatchDecoder.hpp"
+#include "Encoder.hpp"
+
+#include <atomic>
+#include <vector>
+
+using namespace ZCMessagePack;
+
+// Encodes {"data": [0, 1, ...], "id": i} with uneven sizes
+static std::vector<std::vector<uint8_t>> makeMessages(uint32_t f_numMessages)
+{
+    std::vector<std::vector<uint8_t>> messages;
+    for(uint32_t i = 0; i < f_numMessages; i++)
+    {
+        uint32_t numElements = (i * 7919) % 200;
+        std::vector<uint8_t> message(20 + numElements * 5);
+        LargeEncoder encoder(message.data(), message.size());
+        encoder.addMap(2);
+        encoder.addString("data");
+        encoder.addArray(numElements);
+        for(uint32_t element = 0; element < numElements; element++)
+        {
+            encoder.addUint(element);
+        }
+        encoder.addString("id");
+        encoder.addUint(i);
+        message.resize(encoder.getMessageSize());
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+TEST_CASE( "BatchDecode_Ordering", "" ) {
+    auto messages = makeMessages(5000);
+    std::vector<BinarySpan> spans;
+    for(auto & message : messages)
+    {
+        spans.push_back(BinarySpan{message.data(), message.size()});
+    }
+
+    for(unsigned numThreads : {1u, 2u, 4u, 7u})
+    {
+        BatchDecoder batchDecoder(numThreads);
+        REQUIRE(batchDecoder.getNumThreads() == numThreads);
+        // the pool is reused for several batches
+        for(int batch = 0; batch < 3; batch++)
+        {
+            std::vector<uint32_t> ids(spans.size(), UINT32_MAX);
+            std::atomic<uint32_t> numCalls{0};
+            batchDecoder.decode(spans.data(), spans.size(), [&](LargeDecoder f_message) {
+                    numCalls++;
+                    return f_message["id"].getUint32().get();
+                }, ids.data());
+            REQUIRE(numCalls == spans.size());
+            for(uint32_t i = 0; i < ids.size(); i++)
+            {
+                REQUIRE(ids[i] == i);
+            }
+        }
+    }
+}
+
+TEST_CASE( "BatchDecode_SmallBatches", "" ) {
+    auto messages = makeMessages(3);
+    std::vector<BinarySpan> spans;
+    for(auto & message : messages)
+    {
+        spans.push_back(BinarySpan{message.data(), message.size()});
+    }
+    // invalid message
+    uint8_t invalid[] = {0xc1};
+    spans.push_back(BinarySpan{invalid, sizeof(invalid)});
+
+    BatchDecoder batchDecoder(8);
+    uint32_t sizes[4] = {};
+    batchDecoder.decode(spans.data(), 0, [](LargeDecoder) { return 1u; }, sizes);
+    REQUIRE(sizes[0] == 0);
+
+    bool valid[4];
+    batchDecoder.decode(spans.data(), spans.size(), [](LargeDecoder f_message) {
+            return f_message.getMapSize().isValid();
+        }, valid);
+    REQUIRE(valid[0] == true);
+    REQUIRE(valid[2] == true);
+    REQUIRE(valid[3] == false);
+}
+
+TEST_CASE( "BatchDecode_OversizeMessage", "" ) {
+    if(sizeof(size_t) <= sizeof(uint32_t))
+    {
+        return;
+    }
+    auto messages = makeMessages(1);
+    // only the size exceeds 32 bit, the data must not be read
+    BinarySpan spans[2] = {
+        BinarySpan{messages[0].data(), messages[0].size()},
+        BinarySpan{messages[0].data(), static_cast<size_t>(UINT32_MAX) + 1}
+    };
+
+    BatchDecoder batchDecoder(2);
+    bool valid[2];
+    batchDecoder.decode(spans, 2, [](LargeDecoder f_message) {
+            return f_message.isValid() and f_message.getMapSize().isValid();
+        }, valid);
+    REQUIRE(valid[0] == true);
+    REQUIRE(valid[1] == false);
+}
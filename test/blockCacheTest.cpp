@@ -0,0 +1,170 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "BlockCache.hpp"
+#include "Decoder.hpp"
+#include "Encoder.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace ZCMessagePack;
+
+// Slow reader stand-in: counts reads and checks they stay within the message.
+class CountingReader
+{
+    public:
+    CountingReader(const std::vector<uint8_t> & f_message, uint32_t & f_out_numReads) :
+        message(f_message),
+        numReads(f_out_numReads)
+    {
+    }
+
+    void read(uint32_t f_offset, uint32_t f_size, uint8_t * f_out_buffer) const
+    {
+        REQUIRE(static_cast<size_t>(f_offset) + f_size <= message.size());
+        numReads++;
+        for(uint32_t i = 0; i < f_size; i++)
+        {
+            f_out_buffer[i] = message[f_offset + i];
+        }
+    }
+    private:
+    const std::vector<uint8_t> & message;
+    uint32_t & numReads;
+};
+
+TEST_CASE( "BlockCache_Decode", "" ) {
+    std::vector<uint8_t> message(1000);
+    LargeEncoder encoder(message.data(), message.size());
+    encoder.addMap(3);
+    encoder.addString("a");
+    encoder.addString("foo");
+    encoder.addString("blob");
+    std::vector<uint8_t> blob(300, 0x55);
+    blob.back() = 0xaa;
+    encoder.addBinary(blob.data(), blob.size());
+    encoder.addString("last");
+    encoder.addUint(0x0102);
+    message.resize(encoder.getMessageSize());
+
+    using Cache = BlockCache<CountingReader, 64>;
+    uint32_t numReads = 0;
+    Cache cache(CountingReader(message, numReads), message.size());
+    GenericDecoder<Cache::Reader, uint32_t> decoder(cache.getReader(), message.size());
+
+    REQUIRE(decoder.getMapSize().get() == 3);
+    REQUIRE(cache.getMisses() == 1);
+    REQUIRE(cache.getHits() == 0);
+
+    REQUIRE(decoder["a"].compareString("foo").get() == true);
+    REQUIRE(decoder["a"].compareString("bar").get() == false);
+    REQUIRE(numReads == 1);
+    REQUIRE(cache.getMisses() == 1);
+    REQUIRE(cache.getHits() > 0);
+
+    // binary payload is bigger than a block and bypasses the cache
+    std::vector<uint8_t> readBlob(300);
+    REQUIRE(decoder["blob"].getBinary(readBlob.data(), readBlob.size()).get() == 300);
+    REQUIRE(readBlob == blob);
+
+    // "last" is located behind the blob at offset 314, its value header is
+    // the last byte of block 4, the payload is in the (truncated) block 5
+    cache.resetCounters();
+    REQUIRE(decoder["last"].getUint16().get() == 0x0102);
+    REQUIRE(cache.getMisses() == 2);
+    REQUIRE(cache.getHits() > 0);
+    REQUIRE(decoder["missing"].isValid() == false);
+}
+
+TEST_CASE( "BlockCache_ReadAcrossBlocks", "" ) {
+    std::vector<uint8_t> message(100);
+    for(size_t i = 0; i < message.size(); i++)
+    {
+        message[i] = i;
+    }
+
+    uint32_t numReads = 0;
+    BlockCache<CountingReader, 16, 2> cache(CountingReader(message, numReads), message.size());
+
+    uint8_t buffer[8];
+    cache.read(12u, 8u, buffer);
+    for(uint8_t i = 0; i < 8; i++)
+    {
+        REQUIRE(buffer[i] == 12 + i);
+    }
+    REQUIRE(cache.getMisses() == 2);
+    REQUIRE(cache.getHits() == 0);
+
+    // blocks 0 and 1 are both cached (slots 0 and 1)
+    cache.read(0u, 1u, buffer);
+    cache.read(31u, 1u, buffer);
+    REQUIRE(buffer[0] == 31);
+    REQUIRE(cache.getMisses() == 2);
+    REQUIRE(cache.getHits() == 2);
+
+    // block 2 evicts block 0
+    cache.read(33u, 1u, buffer);
+    REQUIRE(buffer[0] == 33);
+    cache.read(1u, 1u, buffer);
+    REQUIRE(buffer[0] == 1);
+    REQUIRE(cache.getMisses() == 4);
+
+    // last block is truncated to the message size
+    cache.read(99u, 1u, buffer);
+    REQUIRE(buffer[0] == 99);
+
+    cache.invalidate();
+    numReads = 0;
+    cache.read(99u, 1u, buffer);
+    REQUIRE(numReads == 1);
+}
+
+TEST_CASE( "BlockCache_ReadBehindMessage", "" ) {
+    std::vector<uint8_t> message(100, 0x11);
+
+    uint32_t numReads = 0;
+    BlockCache<CountingReader, 16> cache(CountingReader(message, numReads), message.size());
+
+    // partly behind the message: only the part within is read
+    uint8_t buffer[40];
+    std::memset(buffer, 0xff, sizeof(buffer));
+    cache.read(98u, 4u, buffer);
+    REQUIRE(buffer[0] == 0x11);
+    REQUIRE(buffer[1] == 0x11);
+    REQUIRE(buffer[2] == 0);
+    REQUIRE(buffer[3] == 0);
+
+    // completely behind the message: nothing is read
+    numReads = 0;
+    std::memset(buffer, 0xff, sizeof(buffer));
+    cache.read(100u, 4u, buffer);
+    cache.read(5000u, 1u, buffer + 4);
+    REQUIRE(numReads == 0);
+    for(uint8_t i = 0; i < 5; i++)
+    {
+        REQUIRE(buffer[i] == 0);
+    }
+
+    // bigger than a block, bypassing the cache
+    std::memset(buffer, 0xff, sizeof(buffer));
+    cache.read(80u, 40u, buffer);
+    REQUIRE(numReads == 1);
+    REQUIRE(buffer[19] == 0x11);
+    REQUIRE(buffer[20] == 0);
+    REQUIRE(buffer[39] == 0);
+}
@@ -16,6 +16,11 @@
 
 #include "Decoder.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
 using namespace ZCMessagePack;
 
 TEST_CASE( "DecodeEmptyMessageBuffer", "" ) {
@@ -1673,3 +1678,851 @@ TEST_CASE( "DecodeArray_Big_ContainingMapsAndArrays", "" ) {
     }
     REQUIRE(decoder.isValid() == true);
 }
+
+TEST_CASE( "DecodeArray_LargeMessage", "" ) {
+    // array of 100 strings "elem" -> 3 + 100 * 5 = 503 bytes
+    std::vector<uint8_t> message{{0xdc, 0, 100}};
+    for(int i = 0; i < 100; i++)
+    {
+        message.insert(message.end(), {0xa4, 'e', 'l', 'e', 'm'});
+    }
+    message.push_back(0x2a);
+    message[2] = 101;
+
+    LargeDecoder decoder(message.data(), message.size());
+
+    REQUIRE(decoder.getArraySize().isValid() == true);
+    REQUIRE(decoder.getArraySize().get() == 101);
+
+    {
+    char str[5];
+    auto strlen = decoder.accessArray(99).getString(str, sizeof(str));
+    REQUIRE(strlen.isValid() == true);
+    REQUIRE(strlen.get() == 4);
+    REQUIRE(std::string(str) == "elem");
+    }
+    {
+    auto i = decoder.accessArray(100).getUint8();
+    REQUIRE(i.isValid() == true);
+    REQUIRE(i.get() == 42);
+    }
+    REQUIRE(decoder.accessArray(101).isValid() == false);
+
+    // the default decoder cannot address this message:
+    Decoder smallDecoder(message.data(), message.size());
+    REQUIRE(smallDecoder.accessArray(100).isValid() == false);
+}
+
+// Reader without data(), forcing GenericDecoder to go through read()
+class NonContiguousReader
+{
+    public:
+    NonContiguousReader(const std::vector<uint8_t> & f_message) : message(f_message) {}
+
+    void read(uint8_t f_offset, uint8_t f_size, uint8_t * f_out_buffer) const
+    {
+        for(uint8_t i = 0; i < f_size; i++)
+        {
+            f_out_buffer[i] = message[f_offset + i];
+        }
+    }
+    private:
+    const std::vector<uint8_t> & message;
+};
+
+TEST_CASE( "DecodeMap_ContiguousAndNonContiguousReader", "" ) {
+    static_assert(HasContiguousData<MemoryReader>::value);
+    static_assert(not HasContiguousData<NonContiguousReader>::value);
+
+    std::vector<uint8_t> message{{
+            0x83,
+            0xa1, 'a', 0xa3, 'f', 'o', 'o',
+            0xa2, 'a', 'b', 0xcd, 0x01, 0x02,
+            0xa3, 'a', 'b', 'c', 0xc4, 0x02, 0x55, 0xaa
+        }};
+
+    Decoder decoder(message.data(), message.size());
+    GenericDecoder<NonContiguousReader> genericDecoder(NonContiguousReader(message), message.size());
+
+    REQUIRE(decoder[""].isValid() == false);
+    REQUIRE(genericDecoder[""].isValid() == false);
+    REQUIRE(decoder["abcd"].isValid() == false);
+    REQUIRE(genericDecoder["abcd"].isValid() == false);
+
+    REQUIRE(decoder["ab"].getUint16().get() == 0x0102);
+    REQUIRE(genericDecoder["ab"].getUint16().get() == 0x0102);
+
+    REQUIRE(decoder["a"].compareString("foo").get() == true);
+    REQUIRE(genericDecoder["a"].compareString("foo").get() == true);
+    REQUIRE(decoder["a"].compareString("fo").get() == false);
+    REQUIRE(genericDecoder["a"].compareString("fo").get() == false);
+    REQUIRE(decoder["a"].compareString("fooo").get() == false);
+    REQUIRE(genericDecoder["a"].compareString("fooo").get() == false);
+
+    uint8_t bin[2];
+    REQUIRE(decoder["abc"].getBinary(bin, sizeof(bin)).get() == 2);
+    REQUIRE(bin[0] == 0x55);
+    REQUIRE(bin[1] == 0xaa);
+    bin[0] = 0;
+    REQUIRE(genericDecoder["abc"].getBinary(bin, sizeof(bin)).get() == 2);
+    REQUIRE(bin[0] == 0x55);
+}
+
+TEST_CASE( "DecodeArray_DeeplyNested", "" ) {
+    // [[[[...[1]...]]]], 42] with 100000 nesting levels
+    const size_t depth = 100000;
+    std::vector<uint8_t> message{{0x92}};
+    message.insert(message.end(), depth, 0x91);
+    message.push_back(0x01);
+    message.push_back(0x2a);
+
+    LargeDecoder decoder(message.data(), message.size());
+    auto i = decoder.accessArray(1).getUint8();
+    REQUIRE(i.isValid() == true);
+    REQUIRE(i.get() == 42);
+
+    // innermost element missing:
+    LargeDecoder truncated(message.data(), depth + 1);
+    REQUIRE(truncated.accessArray(1).isValid() == false);
+}
+
+TEST_CASE( "DecodeArray_HugeElementCount", "" ) {
+    // claims 65535 nested maps with 65535 entries each, but message is short
+    std::vector<uint8_t> message{{0xdc, 0x00, 0x02, 0xdc, 0xff, 0xff, 0xde, 0xff, 0xff, 0xde, 0xff, 0xff, 0x01}};
+
+    Decoder decoder(message.data(), message.size());
+    REQUIRE(decoder.accessArray(1).isValid() == false);
+}
+
+TEST_CASE( "DecodeMap_GetMapValues_TruncatedValue", "" ) {
+    // {"a": 1, "b": <missing>}
+    std::vector<uint8_t> message{{
+            0x82,
+            0xa1, 'a', 0x01,
+            0xa1, 'b'
+        }};
+    Decoder decoder(message.data(), message.size());
+
+    const char * keys[] = {"b", "a"};
+    Decoder values[2];
+    REQUIRE(decoder.getMapValues(keys, values, 2) == 1);
+    REQUIRE(values[0].isValid() == false);
+    REQUIRE(values[1].getUint8().get() == 1);
+}
+
+TEST_CASE( "DecodeMap_GetMapValues", "" ) {
+    std::vector<uint8_t> message{{
+            0x84,
+            0xa1, 'a', 0x01,
+            0xa2, 'b', 'b', 0x92, 0x02, 0x03,
+            0xa1, 'c', 0x81, 0xa1, 'a', 0x04,
+            0xa1, 'd', 0x05
+        }};
+    Decoder decoder(message.data(), message.size());
+
+    {
+    const char * keys[] = {"c", "x", "a", "a", "bb"};
+    Decoder values[5];
+    REQUIRE(values[0].isValid() == false);
+
+    REQUIRE(decoder.getMapValues(keys, values, 5) == 4);
+    REQUIRE(values[0]["a"].getUint8().get() == 4);
+    REQUIRE(values[1].isValid() == false);
+    REQUIRE(values[2].getUint8().get() == 1);
+    REQUIRE(values[3].getUint8().get() == 1);
+    REQUIRE(values[4].accessArray(1).getUint8().get() == 3);
+    }
+    {
+    const char * keys[] = {"d", ""};
+    Decoder values[2];
+    REQUIRE(decoder.getMapValues(keys, values, 2) == 1);
+    REQUIRE(values[0].getUint8().get() == 5);
+    REQUIRE(values[1].isValid() == false);
+    }
+    {
+    const char * keys[] = {"a"};
+    Decoder values[1];
+    REQUIRE(decoder["a"].getMapValues(keys, values, 1) == 0);
+    REQUIRE(values[0].isValid() == false);
+    }
+    {
+    // truncated message
+    const char * keys[] = {"a", "d"};
+    Decoder values[2];
+    Decoder truncated(message.data(), message.size() - 3);
+    REQUIRE(truncated.getMapValues(keys, values, 2) == 1);
+    REQUIRE(values[0].getUint8().get() == 1);
+    REQUIRE(values[1].isValid() == false);
+    }
+}
+
+TEST_CASE( "DecodeArray_Iterate", "" ) {
+    std::vector<uint8_t> message{{
+            0x94,
+            0x01,
+            0x92, 0x02, 0x03,
+            0x81, 0xa1, 'a', 0x04,
+            0x05
+        }};
+    Decoder decoder(message.data(), message.size());
+
+    int count = 0;
+    for(auto & element : decoder.getArrayElements())
+    {
+        REQUIRE(element.isValid() == true);
+        count++;
+    }
+    REQUIRE(count == 4);
+
+    auto elements = decoder.getArrayElements();
+    auto it = elements.begin();
+    REQUIRE(it->getUint8().get() == 1);
+    ++it;
+    REQUIRE(it->accessArray(1).getUint8().get() == 3);
+    ++it;
+    REQUIRE((*it)["a"].getUint8().get() == 4);
+    ++it;
+    REQUIRE(it->getUint8().get() == 5);
+    ++it;
+    REQUIRE(it == elements.end());
+
+    // usable with <iterator> and <algorithm>
+    REQUIRE(std::distance(elements.begin(), elements.end()) == 4);
+    auto found = std::find_if(elements.begin(), elements.end(), [](Decoder & f_element) {
+            return f_element.getMapSize().isValid();
+        });
+    REQUIRE((*found)["a"].getUint8().get() == 4);
+    it = elements.begin();
+    REQUIRE((it++)->getUint8().get() == 1);
+    REQUIRE(it->getArraySize().get() == 2);
+
+    // not an array:
+    auto notArray = decoder.accessArray(0).getArrayElements();
+    REQUIRE(std::distance(notArray.begin(), notArray.end()) == 0);
+    auto notMap = decoder.getMapEntries();
+    REQUIRE(std::distance(notMap.begin(), notMap.end()) == 0);
+
+    // truncated: iteration stops at the broken element
+    Decoder truncated(message.data(), 4);
+    auto truncatedElements = truncated.getArrayElements();
+    REQUIRE(std::distance(truncatedElements.begin(), truncatedElements.end()) == 2);
+}
+
+TEST_CASE( "DecodeMap_Iterate", "" ) {
+    std::vector<uint8_t> message{{
+            0x83,
+            0xa1, 'a', 0x01,
+            0xa2, 'b', 'b', 0x92, 0x02, 0x03,
+            0xa1, 'c', 0x81, 0xa1, 'a', 0x04
+        }};
+    Decoder decoder(message.data(), message.size());
+
+    std::vector<std::string> keys;
+    for(auto & entry : decoder.getMapEntries())
+    {
+        char key[4];
+        REQUIRE(entry.key.getString(key, sizeof(key)).isValid() == true);
+        keys.push_back(key);
+        REQUIRE(entry.value.isValid() == true);
+    }
+    REQUIRE(keys == (std::vector<std::string>{"a", "bb", "c"}));
+
+    auto entries = decoder.getMapEntries();
+    auto it = entries.begin();
+    REQUIRE(it->value.getUint8().get() == 1);
+    ++it;
+    REQUIRE(it->key.compareString("bb").get() == true);
+    REQUIRE(it->value.getArraySize().get() == 2);
+    ++it;
+    REQUIRE(it->value["a"].getUint8().get() == 4);
+    ++it;
+    REQUIRE(it == entries.end());
+
+    it = entries.begin();
+    REQUIRE((it++)->value.getUint8().get() == 1);
+    REQUIRE(it->key.compareString("bb").get() == true);
+    auto found = std::find_if(entries.begin(), entries.end(), [](Decoder::MapEntry & f_entry) {
+            return f_entry.key.compareString("c").get();
+        });
+    REQUIRE(found->value["a"].getUint8().get() == 4);
+
+    // truncated in the middle of the second key:
+    Decoder truncated(message.data(), 6);
+    auto truncatedEntries = truncated.getMapEntries();
+    REQUIRE(std::distance(truncatedEntries.begin(), truncatedEntries.end()) == 1);
+}
+
+TEST_CASE( "DecodeHeader_AllTypeCodes", "" ) {
+    // supported type codes, followed by enough payload bytes for all of them
+    for(int typeCode = 0; typeCode < 256; typeCode++)
+    {
+        std::vector<uint8_t> message{{static_cast<uint8_t>(typeCode), 0, 0, 0, 0, 0, 0, 0, 0}};
+        Decoder decoder(message.data(), message.size());
+        bool supported =
+            typeCode <= 0x7f or typeCode >= 0xe0 or
+            (typeCode >= 0x80 and typeCode <= 0xbf) or
+            typeCode == 0xc0 or typeCode == 0xc2 or typeCode == 0xc3 or
+            (typeCode >= 0xc4 and typeCode <= 0xc6) or (typeCode >= 0xd9 and typeCode <= 0xdf) or
+            typeCode == 0xca or typeCode == 0xcb or
+            (typeCode >= 0xcc and typeCode <= 0xcf) or
+            (typeCode >= 0xd0 and typeCode <= 0xd3);
+        CAPTURE(typeCode);
+        REQUIRE(decoder.isValid() == supported);
+    }
+}
+
+TEST_CASE( "DecodeString_View", "" ) {
+    std::vector<uint8_t> message{{
+            0x83,
+            0xa1, 'a', 0xa5, 'h', 'e', 'l', 'l', 'o',
+            0xa1, 'b', 0xc4, 0x03, 0x00, 0x01, 0x02,
+            0xa1, 'c', 0xa0
+        }};
+    Decoder decoder(message.data(), message.size());
+
+    auto str = decoder["a"].getStringView();
+    REQUIRE(str.isValid() == true);
+    REQUIRE(str.get() == "hello");
+    REQUIRE(str.get().data() == reinterpret_cast<const char *>(message.data() + 4));
+
+    auto bin = decoder["b"].getBinarySpan();
+    REQUIRE(bin.isValid() == true);
+    REQUIRE(bin.get().size == 3);
+    REQUIRE(bin.get().data == message.data() + 13);
+    REQUIRE(bin.get().data[2] == 0x02);
+
+    auto empty = decoder["c"].getStringView();
+    REQUIRE(empty.isValid() == true);
+    REQUIRE(empty.get().empty() == true);
+
+    REQUIRE(decoder.getStringView().isValid() == false);
+    REQUIRE(decoder.getBinarySpan().isValid() == false);
+    REQUIRE(decoder["x"].getStringView().isValid() == false);
+
+    // payload exceeds message:
+    Decoder truncated(message.data(), 8);
+    REQUIRE(truncated["a"].getStringView().isValid() == false);
+}
+
+TEST_CASE( "DecodeFloat", "" ) {
+    {
+    std::vector<uint8_t> message{{0xca, 0x3f, 0xc0, 0x00, 0x00}};
+    Decoder decoder(message.data(), message.size());
+
+    auto f = decoder.getFloat();
+    REQUIRE(f.isValid() == true);
+    REQUIRE(f.get() == 1.5f);
+
+    auto d = decoder.getDouble();
+    REQUIRE(d.isValid() == true);
+    REQUIRE(d.get() == 1.5);
+
+    REQUIRE(decoder.getUint32().isValid() == false);
+    REQUIRE(decoder.isNil().get() == false);
+    }
+    {
+    std::vector<uint8_t> message{{0xcb, 0xc0, 0x09, 0x21, 0xfb, 0x54, 0x44, 0x2d, 0x18}};
+    Decoder decoder(message.data(), message.size());
+
+    REQUIRE(decoder.getFloat().isValid() == false);
+    auto d = decoder.getDouble();
+    REQUIRE(d.isValid() == true);
+    REQUIRE(d.get() == -3.141592653589793);
+    }
+    {
+    // incomplete
+    std::vector<uint8_t> message{{0xcb, 0xc0, 0x09, 0x21, 0xfb, 0x54, 0x44, 0x2d}};
+    Decoder decoder(message.data(), message.size());
+    REQUIRE(decoder.getDouble().isValid() == false);
+
+    std::vector<uint8_t> message2{{0xca, 0x3f, 0xc0, 0x00}};
+    Decoder decoder2(message2.data(), message2.size());
+    REQUIRE(decoder2.getFloat().isValid() == false);
+    REQUIRE(decoder2.getDouble().isValid() == false);
+    }
+    {
+    // not a float
+    std::vector<uint8_t> message{{0x01}};
+    Decoder decoder(message.data(), message.size());
+    REQUIRE(decoder.getFloat().isValid() == false);
+    REQUIRE(decoder.getDouble().isValid() == false);
+    }
+}
+
+TEST_CASE( "DecodeNumber_signed_and_64bit", "" ) {
+    struct TestCase
+    {
+        std::vector<uint8_t> message;
+        bool isNegative;
+        int64_t value;
+    };
+    std::vector<TestCase> cases{{
+        {{0x05}, false, 5},
+        {{0xff}, true, -1},
+        {{0xe0}, true, -32},
+        {{0xd0, 0x80}, true, -128},
+        {{0xd0, 0x7f}, false, 127},
+        {{0xd1, 0xff, 0x7f}, true, -129},
+        {{0xd2, 0xff, 0xff, 0x00, 0x00}, true, -65536},
+        {{0xd2, 0x00, 0x01, 0x00, 0x00}, false, 65536},
+        {{0xd3, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, true, INT64_MIN},
+        {{0xcf, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00}, false, 4294967296},
+        {{0xcf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2a}, false, 42},
+    }};
+    for(auto & testCase : cases)
+    {
+        CAPTURE(testCase.value);
+        Decoder decoder(testCase.message.data(), testCase.message.size());
+
+        auto i64 = decoder.getInt64();
+        REQUIRE(i64.isValid() == true);
+        REQUIRE(i64.get() == testCase.value);
+
+        REQUIRE(decoder.getUint64().isValid() == not testCase.isNegative);
+        if(not testCase.isNegative)
+        {
+            REQUIRE(decoder.getUint64().get() == static_cast<uint64_t>(testCase.value));
+        }
+        REQUIRE(decoder.getUint32().isValid() == (testCase.value >= 0 and testCase.value <= UINT32_MAX));
+        REQUIRE(decoder.getInt32().isValid() == (testCase.value >= INT32_MIN and testCase.value <= INT32_MAX));
+        REQUIRE(decoder.getInt16().isValid() == (testCase.value >= INT16_MIN and testCase.value <= INT16_MAX));
+        REQUIRE(decoder.getInt8().isValid() == (testCase.value >= INT8_MIN and testCase.value <= INT8_MAX));
+        if(decoder.getInt8().isValid())
+        {
+            REQUIRE(decoder.getInt8().get() == testCase.value);
+        }
+
+        // incomplete:
+        Decoder truncated(testCase.message.data(), testCase.message.size() - 1);
+        REQUIRE(truncated.getInt64().isValid() == false);
+    }
+
+    {
+    std::vector<uint8_t> message{{0xcf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}};
+    Decoder decoder(message.data(), message.size());
+    REQUIRE(decoder.getUint64().get() == UINT64_MAX);
+    REQUIRE(decoder.getInt64().isValid() == false);
+    }
+    {
+    std::vector<uint8_t> message{{0xc3}};
+    Decoder decoder(message.data(), message.size());
+    REQUIRE(decoder.getInt64().isValid() == false);
+    REQUIRE(decoder.getInt8().isValid() == false);
+    }
+}
+
+TEST_CASE( "DecodeString_16_32", "" ) {
+    std::vector<uint8_t> str16{{0xda, 0x01, 0x00}};
+    str16.insert(str16.end(), 256, 'a');
+    std::vector<uint8_t> bin32{{0xc6, 0x00, 0x01, 0x00, 0x00}};
+    bin32.insert(bin32.end(), 65536, 0x55);
+
+    {
+    LargeDecoder decoder(str16.data(), str16.size());
+    auto view = decoder.getStringView();
+    REQUIRE(view.isValid() == true);
+    REQUIRE(view.get() == std::string(256, 'a'));
+
+    std::vector<char> str(300);
+    auto len = decoder.getString(str.data(), str.size());
+    REQUIRE(len.isValid() == true);
+    REQUIRE(len.get() == 256);
+    REQUIRE(decoder.compareString(std::string(256, 'a').c_str()).get() == true);
+    REQUIRE(decoder.compareString(std::string(255, 'a').c_str()).get() == false);
+
+    LargeDecoder truncated(str16.data(), str16.size() - 1);
+    REQUIRE(truncated.getStringView().isValid() == false);
+    }
+    {
+    LargeDecoder decoder(bin32.data(), bin32.size());
+    auto span = decoder.getBinarySpan();
+    REQUIRE(span.isValid() == true);
+    REQUIRE(span.get().size == 65536);
+    REQUIRE(span.get().data[65535] == 0x55);
+
+    LargeDecoder truncated(bin32.data(), bin32.size() - 1);
+    REQUIRE(truncated.getBinarySpan().isValid() == false);
+    }
+    {
+    // length claims more than the message (and more than 32 bit positions can address)
+    std::vector<uint8_t> message{{0xdb, 0xff, 0xff, 0xff, 0xff, 'a'}};
+    LargeDecoder decoder(message.data(), message.size());
+    REQUIRE(decoder.getStringView().isValid() == false);
+    REQUIRE(decoder.compareString("a").isValid() == false);
+    }
+}
+
+TEST_CASE( "DecodeArray_Map_32", "" ) {
+    // array32 containing 70000 elements, last one is a map32 with one entry
+    const uint32_t numElements = 70000;
+    std::vector<uint8_t> message{{0xdd, 0x00, 0x01, 0x11, 0x70}};
+    message.insert(message.end(), numElements - 1, 0x01);
+    message.insert(message.end(), {0xdf, 0x00, 0x00, 0x00, 0x01, 0xa1, 'a', 0x2a});
+
+    LargeDecoder decoder(message.data(), message.size());
+    REQUIRE(decoder.getArraySize().get() == numElements);
+    REQUIRE(decoder.accessArray(numElements - 1).getMapSize().get() == 1);
+    REQUIRE(decoder.accessArray(numElements - 1)["a"].getUint8().get() == 42);
+    REQUIRE(decoder.accessArray(numElements).isValid() == false);
+
+    auto elements = decoder.getArrayElements();
+    REQUIRE(std::distance(elements.begin(), elements.end()) == numElements);
+}
+
+// Prints all visited elements in a JSON like notation
+struct PrintingVisitor
+{
+    std::string out;
+    bool onMapBegin(uint32_t f_numEntries) { out += "{" + std::to_string(f_numEntries) + ":"; return true; }
+    bool onMapEnd() { out += "}"; return true; }
+    bool onArrayBegin(uint32_t f_numElements) { out += "[" + std::to_string(f_numElements) + ":"; return true; }
+    bool onArrayEnd() { out += "]"; return true; }
+    bool onKey(std::string_view f_key) { out += std::string(f_key) + "="; return true; }
+    bool onNil() { out += "nil,"; return true; }
+    bool onBool(bool f_value) { out += f_value ? "true," : "false,"; return true; }
+    bool onUint(uint64_t f_value) { out += "u" + std::to_string(f_value) + ","; return true; }
+    bool onInt(int64_t f_value) { out += "i" + std::to_string(f_value) + ","; return true; }
+    bool onFloat(float f_value) { out += "f" + std::to_string(f_value) + ","; return true; }
+    bool onDouble(double f_value) { out += "d" + std::to_string(f_value) + ","; return true; }
+    bool onString(std::string_view f_value) { out += "'" + std::string(f_value) + "',"; return true; }
+    bool onBinary(BinarySpan f_value) { out += "bin" + std::to_string(f_value.size) + ","; return true; }
+};
+
+TEST_CASE( "DecodeVisit", "" ) {
+    std::vector<uint8_t> message{{
+            0x85,
+            0xa1, 'a', 0x93, 0x01, 0xff, 0xcb, 0x3f, 0xf8, 0, 0, 0, 0, 0, 0,
+            0xa1, 'b', 0x82, 0xa1, 'c', 0xc0, 0x07, 0xc3,
+            0xa1, 'd', 0x90,
+            0xa1, 'e', 0xc4, 0x02, 0x55, 0xaa,
+            0xa1, 'f', 0x91, 0xa3, 'f', 'o', 'o'
+        }};
+    Decoder decoder(message.data(), message.size());
+
+    PrintingVisitor visitor;
+    REQUIRE(decoder.visit(visitor) == true);
+    REQUIRE(visitor.out == "{5:a=[3:u1,i-1,d1.500000,]b={2:c=nil,u7,true,}d=[0:]e=bin2,f=[1:'foo',]}");
+
+    // sub elements can be visited as well
+    PrintingVisitor subVisitor;
+    REQUIRE(decoder["b"].visit(subVisitor) == true);
+    REQUIRE(subVisitor.out == "{2:c=nil,u7,true,}");
+
+    // nesting depth limit
+    PrintingVisitor limitedVisitor;
+    REQUIRE(decoder.visit<1>(limitedVisitor) == false);
+    // the array exceeding the limit is not begun
+    REQUIRE(limitedVisitor.out == "{5:a=");
+    REQUIRE(decoder.visit<2>(limitedVisitor) == true);
+
+    // truncated messages
+    for(size_t size = 0; size < message.size(); size++)
+    {
+        Decoder truncated(message.data(), size);
+        PrintingVisitor truncatedVisitor;
+        REQUIRE(truncated.visit(truncatedVisitor) == false);
+    }
+}
+
+TEST_CASE( "DecodeVisit_Abort", "" ) {
+    // counts integers, stops at the first string
+    struct CountingVisitor : VisitorBase
+    {
+        uint32_t numIntegers = 0;
+        bool onUint(uint64_t) { numIntegers++; return true; }
+        bool onString(std::string_view) { return false; }
+    };
+
+    std::vector<uint8_t> message{{0x94, 0x01, 0x02, 0xa1, 'x', 0x03}};
+    Decoder decoder(message.data(), message.size());
+    CountingVisitor visitor;
+    REQUIRE(decoder.visit(visitor) == false);
+    REQUIRE(visitor.numIntegers == 2);
+
+    // deep nesting with a single element per level does not need recursion
+    const size_t depth = 1000;
+    std::vector<uint8_t> nested(depth, 0x91);
+    nested.push_back(0x01);
+    LargeDecoder nestedDecoder(nested.data(), nested.size());
+    CountingVisitor nestedVisitor;
+    REQUIRE(nestedDecoder.visit<depth>(nestedVisitor) == true);
+    REQUIRE(nestedVisitor.numIntegers == 1);
+    REQUIRE(nestedDecoder.visit(nestedVisitor) == false);
+}
+
+// {"id": 1234, "name": "cfg", "flags": [true, -5], "limit": 70000}
+constexpr uint8_t constantMessage[] = {
+    0x84,
+    0xa2, 'i', 'd', 0xcd, 0x04, 0xd2,
+    0xa4, 'n', 'a', 'm', 'e', 0xa3, 'c', 'f', 'g',
+    0xa5, 'f', 'l', 'a', 'g', 's', 0x92, 0xc3, 0xfb,
+    0xa5, 'l', 'i', 'm', 'i', 't', 0xce, 0x00, 0x01, 0x11, 0x70
+};
+constexpr Decoder constantDecoder(constantMessage, sizeof(constantMessage));
+
+TEST_CASE( "DecodeConstexpr", "" ) {
+    static_assert(constantDecoder.getMapSize().get() == 4);
+    static_assert(constantDecoder["id"].getUint16().get() == 1234);
+    static_assert(constantDecoder["id"].getUint8().isValid() == false);
+    static_assert(constantDecoder["name"].compareString("cfg").get());
+    static_assert(not constantDecoder["name"].compareString("cf").get());
+    static_assert(constantDecoder["flags"].getArraySize().get() == 2);
+    static_assert(constantDecoder["flags"].accessArray(0).getBool().get());
+    static_assert(constantDecoder["flags"].accessArray(1).getInt8().get() == -5);
+    static_assert(constantDecoder["limit"].getUint32().get() == 70000);
+    static_assert(constantDecoder["missing"].isValid() == false);
+
+    // the same lookups at runtime
+    REQUIRE(constantDecoder["name"].compareString("cfg").get() == true);
+    REQUIRE(constantDecoder["name"].compareString("cf").get() == false);
+    REQUIRE(constantDecoder["limit"].getUint32().get() == 70000);
+}
+
+TEST_CASE( "DecodePath", "" ) {
+    // {"sensors": [{"temp": 1}, {"temp": 2, "id": [7, 8]}], "name": "x"}
+    std::vector<uint8_t> message{{
+            0x82,
+            0xa7, 's', 'e', 'n', 's', 'o', 'r', 's', 0x92,
+                0x81, 0xa4, 't', 'e', 'm', 'p', 0x01,
+                0x82, 0xa4, 't', 'e', 'm', 'p', 0x02, 0xa2, 'i', 'd', 0x92, 0x07, 0x08,
+            0xa4, 'n', 'a', 'm', 'e', 0xa1, 'x'
+        }};
+    Decoder decoder(message.data(), message.size());
+
+    constexpr auto tempPath = makePath("sensors[1].temp");
+    static_assert(tempPath.isValid());
+    static_assert(tempPath.getNumSteps() == 3);
+    static_assert(tempPath.getStep(0).keyLength == 7);
+    static_assert(tempPath.getStep(1).isIndex and tempPath.getStep(1).index == 1);
+    REQUIRE(decoder[tempPath].getUint8().get() == 2);
+    REQUIRE(decoder[makePath("sensors[0].temp")].getUint8().get() == 1);
+    REQUIRE(decoder[makePath("sensors[1].id[1]")].getUint8().get() == 8);
+    REQUIRE(decoder[makePath("name")].compareString("x").get() == true);
+    REQUIRE(decoder[makePath("")].getMapSize().get() == 2);
+    REQUIRE(decoder["sensors"][makePath("[1].id")].getArraySize().get() == 2);
+
+    // not found
+    REQUIRE(decoder[makePath("sensors[2].temp")].isValid() == false);
+    REQUIRE(decoder[makePath("sensors[1].tem")].isValid() == false);
+    REQUIRE(decoder[makePath("sensors.temp")].isValid() == false);
+    REQUIRE(decoder[makePath("name[0]")].isValid() == false);
+
+    // syntax errors
+    static_assert(not makePath(".name").isValid());
+    static_assert(not makePath("name.").isValid());
+    static_assert(not makePath("a..b").isValid());
+    static_assert(not makePath("a[1]b").isValid());
+    static_assert(not makePath("a[]").isValid());
+    static_assert(not makePath("a[1").isValid());
+    static_assert(not makePath("a[x]").isValid());
+    static_assert(not makePath("a[4294967296]").isValid());
+    static_assert(makePath("a[4294967295]").isValid());
+    REQUIRE(decoder[makePath("name.")].isValid() == false);
+
+    // more steps than MaxSteps
+    static_assert(not Path<2>("a.b.c").isValid());
+    static_assert(Path<2>("a.b").isValid());
+    std::string longPath = "a.b.c.d";
+    Path<2> truncated(longPath.c_str());
+    REQUIRE(truncated.isValid() == false);
+    REQUIRE(truncated.getNumSteps() == 2);
+    REQUIRE(decoder[truncated].isValid() == false);
+}
+
+TEST_CASE( "DecodePath_Constexpr", "" ) {
+    static_assert(constantDecoder[makePath("flags[1]")].getInt8().get() == -5);
+    static_assert(constantDecoder[makePath("name")].compareString("cfg").get());
+}
+
+TEST_CASE( "DecodeInstrumentation", "" ) {
+    // {"a": 1, "bb": [1, 2], "c": 300}
+    std::vector<uint8_t> message{{
+            0x83,
+            0xa1, 'a', 0x01,
+            0xa2, 'b', 'b', 0x92, 0x01, 0x02,
+            0xa1, 'c', 0xcd, 0x01, 0x2c
+        }};
+    using CountingDecoder = GenericDecoder<MemoryReader, uint8_t, CountingInstrumentation>;
+    static_assert(sizeof(CountingDecoder) == sizeof(Decoder));
+    CountingDecoder decoder(message.data(), message.size());
+
+    CountingInstrumentation::resetStats();
+    REQUIRE(decoder["c"].getUint16().get() == 300);
+    DecoderStats stats = CountingInstrumentation::getStats();
+    // map, 3 keys, 2 skipped values (array counts 3), value
+    REQUIRE(stats.decodeHeaderCalls == 9);
+    // 9 type bytes, 2 key bytes compared ("bb" differs in length), uint16 payload
+    REQUIRE(stats.bytesRead == 13);
+    REQUIRE(stats.seekNextElementCalls == 2);
+    REQUIRE(stats.keyComparisons == 3);
+
+    // not counted without instrumentation
+    CountingInstrumentation::resetStats();
+    Decoder plainDecoder(message.data(), message.size());
+    REQUIRE(plainDecoder["c"].getUint16().get() == 300);
+    REQUIRE(CountingInstrumentation::getStats().decodeHeaderCalls == 0);
+}
+
+TEST_CASE( "DecodeGet", "" ) {
+    // [nil, true, 300, -200, 1.5f, 2.5, "abc", bin[2], 0xffffffffff]
+    std::vector<uint8_t> message{{
+            0x99,
+            0xc0,
+            0xc3,
+            0xcd, 0x01, 0x2c,
+            0xd1, 0xff, 0x38,
+            0xca, 0x3f, 0xc0, 0x00, 0x00,
+            0xcb, 0x40, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0xa3, 'a', 'b', 'c',
+            0xc4, 0x02, 0x01, 0x02,
+            0xcf, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff
+        }};
+    Decoder decoder(message.data(), message.size());
+
+    REQUIRE(decoder.accessArray(0).get<bool>().isValid() == false);
+    REQUIRE(decoder.accessArray(1).get<bool>().get() == true);
+    REQUIRE(decoder.accessArray(1).get<uint8_t>().isValid() == false);
+
+    Decoder number = decoder.accessArray(2);
+    REQUIRE(number.get<uint16_t>().get() == 300);
+    REQUIRE(number.get<int16_t>().get() == 300);
+    REQUIRE(number.get<uint64_t>().get() == 300);
+    REQUIRE(number.get<uint8_t>().isValid() == false);
+    REQUIRE(number.get<int8_t>().isValid() == false);
+    REQUIRE(number.get<double>().isValid() == false);
+
+    Decoder negative = decoder.accessArray(3);
+    REQUIRE(negative.get<int16_t>().get() == -200);
+    REQUIRE(negative.get<int64_t>().get() == -200);
+    REQUIRE(negative.get<int8_t>().isValid() == false);
+    REQUIRE(negative.get<uint32_t>().isValid() == false);
+
+    REQUIRE(decoder.accessArray(4).get<float>().get() == 1.5f);
+    REQUIRE(decoder.accessArray(4).get<double>().get() == 1.5);
+    REQUIRE(decoder.accessArray(5).get<float>().isValid() == false);
+    REQUIRE(decoder.accessArray(5).get<double>().get() == 2.5);
+
+    REQUIRE(decoder.accessArray(6).get<std::string_view>().get() == "abc");
+    REQUIRE(decoder.accessArray(6).get<uint8_t>().isValid() == false);
+    BinarySpan span = decoder.accessArray(7).get<BinarySpan>().get();
+    REQUIRE(span.size == 2);
+    REQUIRE(span.data[1] == 0x02);
+
+    REQUIRE(decoder.accessArray(8).get<uint64_t>().get() == 0xffffffffffull);
+    REQUIRE(decoder.accessArray(8).get<uint32_t>().isValid() == false);
+    REQUIRE(decoder.accessArray(8).get<int64_t>().get() == 0xffffffffffll);
+
+    static_assert(constantDecoder["id"].get<uint16_t>().get() == 1234);
+    static_assert(constantDecoder["flags"].accessArray(1).get<int8_t>().get() == -5);
+}
+
+TEST_CASE( "DecodeValue", "" ) {
+    // {"a": nil, "b": 300, "c": [1, 2]}
+    std::vector<uint8_t> message{{
+            0x83,
+            0xa1, 'a', 0xc0,
+            0xa1, 'b', 0xcd, 0x01, 0x2c,
+            0xa1, 'c', 0x92, 0x01, 0x02
+        }};
+    using CountingDecoder = GenericDecoder<MemoryReader, uint8_t, CountingInstrumentation>;
+    CountingDecoder decoder(message.data(), message.size());
+
+    auto nilValue = decoder["a"].getValue();
+    REQUIRE(nilValue.isValid() == true);
+    REQUIRE(nilValue.isNil() == true);
+    REQUIRE(nilValue.get<uint32_t>().isValid() == false);
+
+    auto value = decoder["b"].getValue();
+    CountingInstrumentation::resetStats();
+    REQUIRE(value.isNil() == false);
+    REQUIRE(value.getType() == HeaderInfo::Uint);
+    REQUIRE(value.get<uint8_t>().isValid() == false);
+    REQUIRE(value.get<uint16_t>().get() == 300);
+    REQUIRE(value.get<int32_t>().get() == 300);
+    // the header is decoded once, by getValue()
+    REQUIRE(CountingInstrumentation::getStats().decodeHeaderCalls == 0);
+    REQUIRE(value.getSize().isValid() == false);
+
+    auto array = decoder["c"].getValue();
+    REQUIRE(array.getType() == HeaderInfo::Array);
+    REQUIRE(array.getSize().get() == 2);
+    REQUIRE(array.getDecoder().accessArray(1).get<uint8_t>().get() == 2);
+
+    REQUIRE(decoder["d"].getValue().isValid() == false);
+    static_assert(constantDecoder["id"].getValue().get<uint16_t>().get() == 1234);
+}
+
+TEST_CASE( "DecodeCompareString_Lengths", "" ) {
+    // covers all code paths of equalBytes() (short, word, block and tail compares)
+    for(uint32_t length = 0; length < 70; length++)
+    {
+        std::string string;
+        for(uint32_t i = 0; i < length; i++)
+        {
+            string += static_cast<char>('a' + i % 26);
+        }
+        std::vector<uint8_t> message;
+        if(length < 32)
+        {
+            message.push_back(0xa0 | length);
+        }
+        else
+        {
+            message.insert(message.end(), {0xd9, static_cast<uint8_t>(length)});
+        }
+        message.insert(message.end(), string.begin(), string.end());
+        Decoder decoder(message.data(), message.size());
+
+        REQUIRE(decoder.compareString(string.c_str()).get() == true);
+        REQUIRE(decoder.compareString(string.c_str(), string.size()).get() == true);
+        REQUIRE(decoder.compareString((string + "x").c_str()).get() == false);
+        REQUIRE(decoder.compareString(string.c_str(), string.size() + 1).get() == false);
+        for(uint32_t position = 0; position < length; position++)
+        {
+            std::string modified = string;
+            modified[position] = 'X';
+            REQUIRE(decoder.compareString(modified.c_str()).get() == false);
+            REQUIRE(decoder.compareString(modified.c_str(), modified.size()).get() == false);
+            REQUIRE(decoder.compareString(string.c_str(), position).get() == false);
+        }
+    }
+}
+
+TEST_CASE( "DecodeKey", "" ) {
+    // {"a": 1, "abcdefgh": 2, "abcdefghX": 3, "abcdefghY": 4, "b": 5}
+    std::vector<uint8_t> message{{
+            0x85,
+            0xa1, 'a', 0x01,
+            0xa8, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 0x02,
+            0xa9, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'X', 0x03,
+            0xa9, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'Y', 0x04,
+            0xa1, 'b', 0x05
+        }};
+    Decoder decoder(message.data(), message.size());
+
+    constexpr Key shortKey("a");
+    static_assert(shortKey.size() == 1);
+    static_assert(shortKey.getPrefix() == 'a');
+    static_assert(shortKey.getPrefixMask() == 0xff);
+    constexpr Key longKey("abcdefghY");
+    static_assert(longKey.size() == 9);
+    static_assert(longKey.getPrefixMask() == ~static_cast<uint64_t>(0));
+
+    REQUIRE(decoder[shortKey].getUint8().get() == 1);
+    REQUIRE(decoder[Key("abcdefgh")].getUint8().get() == 2);
+    REQUIRE(decoder[Key("abcdefghX")].getUint8().get() == 3);
+    REQUIRE(decoder[longKey].getUint8().get() == 4);
+    // last key: too close to the message end for a prefix load
+    REQUIRE(decoder[Key("b")].getUint8().get() == 5);
+    REQUIRE(decoder[Key("abcdefgY")].isValid() == false);
+    REQUIRE(decoder[Key("abcdefghZ")].isValid() == false);
+    REQUIRE(decoder[Key("")].isValid() == false);
+    REQUIRE(decoder[Key("bX", 1)].getUint8().get() == 5);
+
+    Decoder cursor = decoder;
+    cursor.seekElementByKey(Key("abcdefghX"));
+    REQUIRE(cursor.getUint8().get() == 3);
+
+    static_assert(constantDecoder[Key("limit")].getUint32().get() == 70000);
+    static_assert(constantDecoder[Key("missing")].isValid() == false);
+}
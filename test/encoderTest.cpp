@@ -271,8 +271,7 @@ TEST_CASE( "EncodeNumber_u32", "" ) {
   }
 }
 
-TEST_CASE( "EncodeNumber_u64", "[!shouldfail]" ) {
-  // Failing as Encoder does not support uint64_t
+TEST_CASE( "EncodeNumber_u64", "" ) {
   std::vector<uint8_t> message{{0xcf, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00}};
   uint64_t bignum = 4294967296;
   {
@@ -991,8 +990,8 @@ TEST_CASE( "EncodeNumber_i32", "" ) {
     auto result = encoder.addInt(0);
 
     REQUIRE(result == true);
-    REQUIRE(encoder.getMessageSize() == 5);
-    REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == (std::vector<uint8_t>{{0xd2, 0x00, 0x00, 0x00, 0x00}}));
+    REQUIRE(encoder.getMessageSize() == 1);
+    REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == (std::vector<uint8_t>{{0x00}}));
   }
   {
     uint8_t buf[5];
@@ -1001,8 +1000,8 @@ TEST_CASE( "EncodeNumber_i32", "" ) {
     auto result = encoder.addInt(-1);
 
     REQUIRE(result == true);
-    REQUIRE(encoder.getMessageSize() == 5);
-    REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == (std::vector<uint8_t>{{0xd2, 0xff, 0xff, 0xff, 0xff}}));
+    REQUIRE(encoder.getMessageSize() == 1);
+    REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == (std::vector<uint8_t>{{0xff}}));
   }
   {
     uint8_t buf[5];
@@ -1017,3 +1016,180 @@ TEST_CASE( "EncodeNumber_i32", "" ) {
 
 }
 
+TEST_CASE( "EncodeNumber_smallest_signed", "" ) {
+  std::vector<std::pair<int64_t, std::vector<uint8_t>>> cases{{
+    {1, {0x01}},
+    {200, {0xcc, 0xc8}},
+    {-32, {0xe0}},
+    {-33, {0xd0, 0xdf}},
+    {-128, {0xd0, 0x80}},
+    {-129, {0xd1, 0xff, 0x7f}},
+    {-32768, {0xd1, 0x80, 0x00}},
+    {-32769, {0xd2, 0xff, 0xff, 0x7f, 0xff}},
+    {INT32_MIN, {0xd2, 0x80, 0x00, 0x00, 0x00}},
+    {static_cast<int64_t>(INT32_MIN) - 1, {0xd3, 0xff, 0xff, 0xff, 0xff, 0x7f, 0xff, 0xff, 0xff}},
+    {INT64_MIN, {0xd3, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+    {INT64_MAX, {0xcf, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}},
+  }};
+  for(auto & testCase : cases)
+  {
+    CAPTURE(testCase.first);
+    {
+      uint8_t buf[9];
+      Encoder encoder(buf, testCase.second.size() - 1);
+      REQUIRE(encoder.addInt(testCase.first) == false);
+      REQUIRE(encoder.getMessageSize() == 0);
+    }
+    {
+      uint8_t buf[9];
+      Encoder encoder(buf, testCase.second.size());
+      REQUIRE(encoder.addInt(testCase.first) == true);
+      REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == testCase.second);
+    }
+  }
+}
+
+TEST_CASE( "EncodeArray_LargeMessage", "" ) {
+  std::vector<uint8_t> message{{0xdc, 0, 100}};
+  for(int i = 0; i < 100; i++)
+  {
+    message.insert(message.end(), {0xa4, 'e', 'l', 'e', 'm'});
+  }
+  {
+    uint8_t buf[600];
+    Encoder encoder(buf, 255);
+
+    bool result = encoder.addArray(100);
+    for(int i = 0; i < 100; i++)
+    {
+      result &= encoder.addString("elem");
+    }
+
+    REQUIRE(result == false);
+  }
+  {
+    uint8_t buf[600];
+    LargeEncoder encoder(buf, sizeof(buf));
+
+    bool result = encoder.addArray(100);
+    for(int i = 0; i < 100; i++)
+    {
+      result &= encoder.addString("elem");
+    }
+
+    REQUIRE(result == true);
+    REQUIRE(encoder.getMessageSize() == message.size());
+    REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == message);
+  }
+}
+
+TEST_CASE( "EncodeFloat", "" ) {
+  {
+    uint8_t buf[4];
+    Encoder encoder(buf, sizeof(buf));
+
+    REQUIRE(encoder.addFloat(1.5f) == false);
+    REQUIRE(encoder.getMessageSize() == 0);
+  }
+  {
+    uint8_t buf[5];
+    Encoder encoder(buf, sizeof(buf));
+
+    REQUIRE(encoder.addFloat(1.5f) == true);
+    REQUIRE(encoder.getMessageSize() == 5);
+    REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == (std::vector<uint8_t>{{0xca, 0x3f, 0xc0, 0x00, 0x00}}));
+  }
+}
+
+TEST_CASE( "EncodeDouble", "" ) {
+  {
+    uint8_t buf[8];
+    Encoder encoder(buf, sizeof(buf));
+
+    REQUIRE(encoder.addDouble(1.5) == false);
+    REQUIRE(encoder.getMessageSize() == 0);
+  }
+  {
+    uint8_t buf[9];
+    Encoder encoder(buf, sizeof(buf));
+
+    REQUIRE(encoder.addDouble(-3.141592653589793) == true);
+    REQUIRE(encoder.getMessageSize() == 9);
+    REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == (std::vector<uint8_t>{{0xcb, 0xc0, 0x09, 0x21, 0xfb, 0x54, 0x44, 0x2d, 0x18}}));
+  }
+}
+
+TEST_CASE( "EncodeString_16_32", "" ) {
+  {
+    std::string str(256, 'a');
+    std::vector<uint8_t> buf(300);
+    LargeEncoder encoder(buf.data(), buf.size());
+
+    REQUIRE(encoder.addString(str.c_str()) == true);
+    REQUIRE(encoder.getMessageSize() == 259);
+    REQUIRE(buf[0] == 0xda);
+    REQUIRE(buf[1] == 0x01);
+    REQUIRE(buf[2] == 0x00);
+    REQUIRE(buf[258] == 'a');
+  }
+  {
+    std::string str(65536, 'a');
+    std::vector<uint8_t> buf(65536 + 5);
+    LargeEncoder encoder(buf.data(), buf.size() - 1);
+    REQUIRE(encoder.addString(str.c_str()) == false);
+    REQUIRE(encoder.getMessageSize() == 0);
+
+    LargeEncoder encoder2(buf.data(), buf.size());
+    REQUIRE(encoder2.addString(str.c_str()) == true);
+    REQUIRE(encoder2.getMessageSize() == 65536 + 5);
+    REQUIRE(std::vector<uint8_t>(buf.begin(), buf.begin() + 5) == (std::vector<uint8_t>{{0xdb, 0x00, 0x01, 0x00, 0x00}}));
+  }
+}
+
+TEST_CASE( "EncodeBinary_16_32", "" ) {
+  {
+    std::vector<uint8_t> data(300, 0x55);
+    std::vector<uint8_t> buf(303);
+    LargeEncoder encoder(buf.data(), buf.size());
+
+    REQUIRE(encoder.addBinary(data.data(), data.size()) == true);
+    REQUIRE(encoder.getMessageSize() == 303);
+    REQUIRE(std::vector<uint8_t>(buf.begin(), buf.begin() + 3) == (std::vector<uint8_t>{{0xc5, 0x01, 0x2c}}));
+  }
+  {
+    std::vector<uint8_t> data(70000, 0x55);
+    std::vector<uint8_t> buf(70005);
+    LargeEncoder encoder(buf.data(), buf.size());
+
+    REQUIRE(encoder.addBinary(data.data(), data.size()) == true);
+    REQUIRE(encoder.getMessageSize() == 70005);
+    REQUIRE(std::vector<uint8_t>(buf.begin(), buf.begin() + 5) == (std::vector<uint8_t>{{0xc6, 0x00, 0x01, 0x11, 0x70}}));
+  }
+}
+
+TEST_CASE( "EncodeMap_Array_16_32", "" ) {
+  {
+    uint8_t buf[3];
+    Encoder encoder(buf, sizeof(buf));
+    REQUIRE(encoder.addMap(0x1234) == true);
+    REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == (std::vector<uint8_t>{{0xde, 0x12, 0x34}}));
+  }
+  {
+    uint8_t buf[5];
+    Encoder encoder(buf, sizeof(buf));
+    REQUIRE(encoder.addMap(0x12345) == true);
+    REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == (std::vector<uint8_t>{{0xdf, 0x00, 0x01, 0x23, 0x45}}));
+  }
+  {
+    uint8_t buf[5];
+    Encoder encoder(buf, sizeof(buf));
+    REQUIRE(encoder.addArray(0x10000) == true);
+    REQUIRE(std::vector<uint8_t>(buf, buf+encoder.getMessageSize()) == (std::vector<uint8_t>{{0xdd, 0x00, 0x01, 0x00, 0x00}}));
+  }
+  {
+    uint8_t buf[4];
+    Encoder encoder(buf, sizeof(buf));
+    REQUIRE(encoder.addArray(0x10000) == false);
+    REQUIRE(encoder.getMessageSize() == 0);
+  }
+}
@@ -0,0 +1,188 @@
+// Copyright 2021 Rainer Schoenberger
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "IndexedDecoder.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace ZCMessagePack;
+
+static std::vector<uint8_t> nestedMessage()
+{
+    return std::vector<uint8_t>{{
+            0xde, 0, 3,
+
+            // "h" -> map
+            0xa1, 'h',
+            0xde, 0, 4,
+            0xa1, 'a', 0xa1, 'A',
+            0xa4, 's', 'd', 'f', 'g', 0x07,
+            0xa2, 'g', 'H', 0xa3, 'h', 'e', 'l',
+            0xa3, 's', 'd', 'f', 0xcc, 42,
+
+            // "ym" -> array
+            0xa2, 'y', 'm',
+            0xdc, 0x00, 0x03,
+            0x01,
+            0x90,
+            0xa3, 'h', 'e', 'l',
+
+            // "int" -> 8
+            0xa3, 'i', 'n', 't',
+            0x08
+        }};
+}
+
+TEST_CASE( "IndexedDecode_Nested", "" ) {
+    auto message = nestedMessage();
+    Decoder decoder(message.data(), message.size());
+
+    IndexedDecoder::Entry index[32];
+    IndexedDecoder indexed(decoder, index, 32);
+
+    REQUIRE(indexed.isValid() == true);
+    // root + 3 * 2 + 4 * 2 + 3
+    REQUIRE(indexed.getNumEntries() == 18);
+    REQUIRE(index[0].offset == 0);
+    REQUIRE(index[0].end == message.size());
+
+    REQUIRE(indexed.getMapSize().get() == 3);
+    REQUIRE(indexed.getArraySize().isValid() == false);
+    REQUIRE(indexed["asd"].isValid() == false);
+    REQUIRE(indexed[""].isValid() == false);
+    REQUIRE(indexed["in"].isValid() == false);
+    REQUIRE(indexed.accessArray(0).isValid() == false);
+
+    REQUIRE(indexed["h"].getMapSize().get() == 4);
+    REQUIRE(indexed["h"]["sdfg"].getDecoder().getUint8().get() == 7);
+    REQUIRE(indexed["h"]["sdf"].getDecoder().getUint8().get() == 42);
+    REQUIRE(indexed["int"].getDecoder().getUint8().get() == 8);
+    {
+    char str[5];
+    auto strlen = indexed["h"]["gH"].getDecoder().getString(str, sizeof(str));
+    REQUIRE(strlen.isValid() == true);
+    REQUIRE(std::string(str) == "hel");
+    }
+
+    REQUIRE(indexed["ym"].getArraySize().get() == 3);
+    REQUIRE(indexed["ym"].accessArray(0).getDecoder().getUint8().get() == 1);
+    REQUIRE(indexed["ym"].accessArray(1).getArraySize().get() == 0);
+    REQUIRE(indexed["ym"].accessArray(2).getDecoder().compareString("hel").get() == true);
+    REQUIRE(indexed["ym"].accessArray(3).isValid() == false);
+    REQUIRE(indexed["ym"].accessArray(3).getDecoder().isValid() == false);
+
+    // same results as without index:
+    REQUIRE(indexed["h"]["sdf"].getDecoder().getUint8().get() == decoder["h"]["sdf"].getUint8().get());
+}
+
+TEST_CASE( "IndexedDecode_IndexTooSmall", "" ) {
+    auto message = nestedMessage();
+    Decoder decoder(message.data(), message.size());
+
+    IndexedDecoder::Entry index[17];
+    IndexedDecoder indexed(decoder, index, 17);
+    REQUIRE(indexed.isValid() == false);
+    REQUIRE(indexed["int"].isValid() == false);
+
+    IndexedDecoder empty(decoder, index, 0);
+    REQUIRE(empty.isValid() == false);
+}
+
+TEST_CASE( "IndexedDecode_Truncated", "" ) {
+    auto message = nestedMessage();
+    IndexedDecoder::Entry index[32];
+    for(size_t size = 0; size < message.size(); size++)
+    {
+        Decoder decoder(message.data(), size);
+        IndexedDecoder indexed(decoder, index, 32);
+        REQUIRE(indexed.isValid() == false);
+    }
+}
+
+TEST_CASE( "IndexedDecode_Scalar", "" ) {
+    std::vector<uint8_t> message{{0xcd, 0x01, 0x00}};
+    Decoder decoder(message.data(), message.size());
+
+    IndexedDecoder::Entry index[1];
+    IndexedDecoder indexed(decoder, index, 1);
+    REQUIRE(indexed.isValid() == true);
+    REQUIRE(indexed.getNumEntries() == 1);
+    REQUIRE(indexed.getDecoder().getUint16().get() == 256);
+    REQUIRE(indexed.getMapSize().isValid() == false);
+    REQUIRE(indexed["a"].isValid() == false);
+}
+
+TEST_CASE( "IndexedDecode_ManyKeys", "" ) {
+    // keys of different length, sharing long prefixes, in message order
+    // "k<n>", "longPrefix_<n>", with values n
+    std::vector<std::string> keys;
+    for(uint32_t i = 0; i < 100; i++)
+    {
+        keys.push_back("k" + std::to_string((i * 37) % 100));
+        keys.push_back("longPrefix_" + std::to_string((i * 37) % 100));
+    }
+    std::vector<uint8_t> message{{0xde, 0, static_cast<uint8_t>(keys.size())}};
+    for(uint32_t i = 0; i < keys.size(); i++)
+    {
+        message.push_back(0xa0 | keys[i].size());
+        message.insert(message.end(), keys[i].begin(), keys[i].end());
+        message.push_back(0xcd);
+        message.push_back(i >> 8);
+        message.push_back(i & 0xff);
+    }
+    // duplicate of the first key: the first one is found
+    message[2]++;
+    message.push_back(0xa0 | keys[0].size());
+    message.insert(message.end(), keys[0].begin(), keys[0].end());
+    message.push_back(0xff);
+
+    LargeDecoder decoder(message.data(), message.size());
+    std::vector<GenericIndexedDecoder<MemoryReader, uint32_t>::Entry> index(1 + 2 * (keys.size() + 1));
+    GenericIndexedDecoder<MemoryReader, uint32_t> indexed(decoder, index.data(), index.size());
+    REQUIRE(indexed.isValid() == true);
+    REQUIRE(indexed.getMapSize().get() == keys.size() + 1);
+
+    for(uint32_t i = 0; i < keys.size(); i++)
+    {
+        REQUIRE(indexed[keys[i].c_str()].getDecoder().getUint16().get() == i);
+        REQUIRE(indexed[keys[i].c_str()].getDecoder().getUint16().get() == decoder[keys[i].c_str()].getUint16().get());
+    }
+    REQUIRE(indexed["k100"].isValid() == false);
+    REQUIRE(indexed["longPrefix_"].isValid() == false);
+    REQUIRE(indexed["longPrefix_100"].isValid() == false);
+    REQUIRE(indexed["a"].isValid() == false);
+    REQUIRE(indexed["zzzzzzzzzzzzzzzzzzzzzzzzzzzzz"].isValid() == false);
+    REQUIRE(indexed[""].isValid() == false);
+}
+
+TEST_CASE( "IndexedDecode_NonStringKey", "" ) {
+    // {"b": 1, 5: 2, "a": 3}
+    std::vector<uint8_t> message{{
+            0x83,
+            0xa1, 'b', 0x01,
+            0x05, 0x02,
+            0xa1, 'a', 0x03
+        }};
+    Decoder decoder(message.data(), message.size());
+    IndexedDecoder::Entry index[7];
+    IndexedDecoder indexed(decoder, index, 7);
+    REQUIRE(indexed.isValid() == true);
+    // searched in message order, like Decoder::operator[]
+    REQUIRE(indexed["b"].getDecoder().getUint8().get() == 1);
+    REQUIRE(indexed["a"].isValid() == false);
+    REQUIRE(decoder["a"].isValid() == false);
+}
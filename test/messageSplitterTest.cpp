@@ -0,0 +1,94 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "MessageSplitter.hpp"
+
+#include <vector>
+
+using namespace ZCMessagePack;
+
+TEST_CASE( "MessageSplitter_Next", "" ) {
+    std::vector<uint8_t> stream{{
+            0x81, 0xa1, 'a', 0x01,
+            0x05,
+            0x92, 0xa1, 'x', 0x81, 0xa1, 'a', 0x02,
+            0x81, 0xa1, 'a', 0x03
+        }};
+    MessageSplitter splitter(stream.data(), stream.size());
+
+    REQUIRE(splitter.atEnd() == false);
+    auto first = splitter.next();
+    REQUIRE(first["a"].getUint8().get() == 1);
+    REQUIRE(splitter.getPosition() == 4);
+
+    auto second = splitter.next();
+    REQUIRE(second.getUint8().get() == 5);
+    // a message decoder does not see the following messages
+    REQUIRE(second.getMapSize().isValid() == false);
+
+    auto third = splitter.next();
+    REQUIRE(third.accessArray(1)["a"].getUint8().get() == 2);
+    REQUIRE(third.accessArray(2).isValid() == false);
+
+    auto fourth = splitter.next();
+    REQUIRE(fourth["a"].getUint8().get() == 3);
+    REQUIRE(splitter.atEnd() == true);
+    REQUIRE(splitter.next().isValid() == false);
+}
+
+TEST_CASE( "MessageSplitter_Truncated", "" ) {
+    std::vector<uint8_t> stream{{
+            0x01,
+            0x81, 0xa1, 'a', 0xa3, 'f', 'o'
+        }};
+    MessageSplitter splitter(stream.data(), stream.size());
+    REQUIRE(splitter.next().getUint8().get() == 1);
+    // string payload is truncated
+    REQUIRE(splitter.next().isValid() == false);
+    REQUIRE(splitter.getPosition() == 1);
+    REQUIRE(splitter.atEnd() == false);
+
+    // invalid type byte
+    std::vector<uint8_t> invalid{{0x01, 0xc1, 0x02}};
+    MessageSplitter invalidSplitter(invalid.data(), invalid.size());
+    REQUIRE(invalidSplitter.countMessages() == 1);
+    REQUIRE(invalidSplitter.getPosition() == 1);
+    REQUIRE(invalidSplitter.atEnd() == false);
+}
+
+TEST_CASE( "MessageSplitter_Scan", "" ) {
+    // 10000 records {"id": i}
+    std::vector<uint8_t> stream;
+    for(uint16_t i = 0; i < 10000; i++)
+    {
+        stream.insert(stream.end(), {0x81, 0xa2, 'i', 'd', 0xcd, static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i)});
+    }
+    LargeMessageSplitter splitter(stream.data(), stream.size());
+
+    std::vector<uint32_t> offsets;
+    uint64_t numMessages = splitter.scan([&](uint32_t f_offset, uint32_t f_size) {
+            REQUIRE(f_size == 7);
+            offsets.push_back(f_offset);
+        });
+    REQUIRE(numMessages == 10000);
+    REQUIRE(offsets.size() == 10000);
+    REQUIRE(offsets[9999] == 9999 * 7);
+    REQUIRE(splitter.atEnd() == true);
+
+    LargeMessageSplitter counter(stream.data(), stream.size());
+    counter.next();
+    REQUIRE(counter.countMessages() == 9999);
+}
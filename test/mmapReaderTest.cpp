@@ -0,0 +1,93 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "MmapReader.hpp"
+#include "Decoder.hpp"
+#include "Encoder.hpp"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ZCMessagePack;
+
+static std::string writeTempFile(const std::vector<uint8_t> & f_content)
+{
+    char path[] = "/tmp/zcmessagepackXXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    if(not f_content.empty())
+    {
+        REQUIRE(write(fd, f_content.data(), f_content.size()) == static_cast<ssize_t>(f_content.size()));
+    }
+    close(fd);
+    return path;
+}
+
+TEST_CASE( "MmapReader_Decode", "" ) {
+    static_assert(HasContiguousData<MmapReader>::value);
+
+    std::vector<uint8_t> message(100000);
+    LargeEncoder encoder(message.data(), message.size());
+    encoder.addMap(2);
+    encoder.addString("list");
+    encoder.addArray(20000);
+    for(uint32_t i = 0; i < 20000; i++)
+    {
+        encoder.addUint(i);
+    }
+    encoder.addString("name");
+    encoder.addString("archive");
+    message.resize(encoder.getMessageSize());
+    std::string path = writeTempFile(message);
+
+    MappedFile file(path.c_str());
+    REQUIRE(file.isValid() == true);
+    REQUIRE(file.size() == message.size());
+    REQUIRE(file.prefetch(message.size() - 20, 100) == true);
+    REQUIRE(file.advise(MappedFile::Sequential) == true);
+
+    GenericDecoder<MmapReader, uint32_t> decoder(file.getReader(), file.size());
+    REQUIRE(decoder["list"].getArraySize().get() == 20000);
+    REQUIRE(decoder["list"].accessArray(19999).getUint16().get() == 19999);
+    REQUIRE(decoder["name"].getStringView().get() == "archive");
+
+    // ownership of the mapping moves
+    MappedFile moved(std::move(file));
+    REQUIRE(file.isValid() == false);
+    REQUIRE(file.data() == nullptr);
+    REQUIRE(moved.isValid() == true);
+    GenericDecoder<MmapReader, uint32_t> movedDecoder(moved.getReader(), moved.size());
+    REQUIRE(movedDecoder["name"].compareString("archive").get() == true);
+
+    remove(path.c_str());
+}
+
+TEST_CASE( "MmapReader_InvalidFiles", "" ) {
+    MappedFile missing("/nonexistent/zcmessagepack");
+    REQUIRE(missing.isValid() == false);
+    REQUIRE(missing.size() == 0);
+    REQUIRE(missing.prefetch(0, 1) == false);
+
+    std::string path = writeTempFile({});
+    MappedFile empty(path.c_str());
+    REQUIRE(empty.isValid() == true);
+    REQUIRE(empty.size() == 0);
+    GenericDecoder<MmapReader, uint32_t> decoder(empty.getReader(), empty.size());
+    REQUIRE(decoder.isValid() == false);
+    remove(path.c_str());
+}
@@ -0,0 +1,148 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "StreamDecoder.hpp"
+#include "Encoder.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace ZCMessagePack;
+
+static std::vector<uint8_t> streamMessage()
+{
+    std::vector<uint8_t> message(1000);
+    LargeEncoder encoder(message.data(), message.size());
+    encoder.addMap(3);
+    encoder.addString("id");
+    encoder.addUint(0x12345678);
+    encoder.addString("text");
+    encoder.addString(std::string(40, 'x').c_str());
+    encoder.addString("values");
+    encoder.addArray(4);
+    encoder.addDouble(1.5);
+    encoder.addInt(-300);
+    encoder.addNil();
+    encoder.addString("");
+    message.resize(encoder.getMessageSize());
+    return message;
+}
+
+// Feeds the stream in chunks of f_chunkSize bytes and logs all events
+static std::string decodeInChunks(const std::vector<uint8_t> & f_stream, size_t f_chunkSize)
+{
+    StreamDecoder stream;
+    std::string log;
+    std::string payload;
+    for(size_t offset = 0; offset < f_stream.size(); offset += f_chunkSize)
+    {
+        size_t chunkSize = f_stream.size() - offset < f_chunkSize ? f_stream.size() - offset : f_chunkSize;
+        std::vector<uint8_t> chunk(f_stream.begin() + offset, f_stream.begin() + offset + chunkSize);
+        REQUIRE(stream.feed(chunk.data(), chunk.size()) == true);
+        StreamDecoder::Status status;
+        while((status = stream.next()) != StreamDecoder::NeedMoreData)
+        {
+            REQUIRE(status != StreamDecoder::Error);
+            if(status == StreamDecoder::PayloadFragment)
+            {
+                BinarySpan fragment = stream.getFragment();
+                REQUIRE(fragment.size > 0);
+                payload.append(reinterpret_cast<const char *>(fragment.data), fragment.size);
+                if(payload.size() == stream.getPayloadSize())
+                {
+                    log += "'" + payload + "' ";
+                }
+            }
+            else
+            {
+                Decoder element = stream.getElement();
+                switch(stream.getType())
+                {
+                    case HeaderInfo::Map: log += "map" + std::to_string(element.getMapSize().get()) + " "; break;
+                    case HeaderInfo::Array: log += "array" + std::to_string(element.getArraySize().get()) + " "; break;
+                    case HeaderInfo::Uint: log += std::to_string(element.getUint32().get()) + " "; break;
+                    case HeaderInfo::Int: log += std::to_string(element.getInt16().get()) + " "; break;
+                    case HeaderInfo::Float: log += std::to_string(element.getDouble().get()) + " "; break;
+                    case HeaderInfo::Nil: log += "nil "; break;
+                    case HeaderInfo::String:
+                        payload.clear();
+                        if(stream.getPayloadSize() == 0)
+                        {
+                            log += "'' ";
+                        }
+                        break;
+                    default: log += "? "; break;
+                }
+            }
+            if(stream.isMessageComplete())
+            {
+                log += "| ";
+            }
+        }
+    }
+    return log;
+}
+
+TEST_CASE( "StreamDecode_Chunks", "" ) {
+    std::vector<uint8_t> message = streamMessage();
+    std::string expected =
+        "map3 'id' 305419896 'text' '" + std::string(40, 'x') + "' 'values' array4 1.500000 -300 nil '' | ";
+
+    for(size_t chunkSize = 1; chunkSize <= message.size(); chunkSize++)
+    {
+        REQUIRE(decodeInChunks(message, chunkSize) == expected);
+    }
+}
+
+TEST_CASE( "StreamDecode_MultipleMessages", "" ) {
+    std::vector<uint8_t> stream = streamMessage();
+    std::vector<uint8_t> second{{0x05, 0x91, 0xcd, 0x01, 0x02}};
+    stream.insert(stream.end(), second.begin(), second.end());
+    stream.insert(stream.end(), second.begin(), second.end());
+
+    std::string first =
+        "map3 'id' 305419896 'text' '" + std::string(40, 'x') + "' 'values' array4 1.500000 -300 nil '' | ";
+    std::string expected = first + "5 | array1 258 | 5 | array1 258 | ";
+    REQUIRE(decodeInChunks(stream, 3) == expected);
+    REQUIRE(decodeInChunks(stream, stream.size()) == expected);
+}
+
+TEST_CASE( "StreamDecode_Errors", "" ) {
+    StreamDecoder stream;
+    REQUIRE(stream.next() == StreamDecoder::NeedMoreData);
+
+    std::vector<uint8_t> chunk{{0x92, 0x01, 0xc1, 0x02}};
+    REQUIRE(stream.feed(chunk.data(), chunk.size()) == true);
+    REQUIRE(stream.next() == StreamDecoder::Element);
+    REQUIRE(stream.isMessageComplete() == false);
+    // previous chunk not consumed yet
+    REQUIRE(stream.feed(chunk.data(), chunk.size()) == false);
+    REQUIRE(stream.next() == StreamDecoder::Element);
+    REQUIRE(stream.getElement().getUint8().get() == 1);
+    // 0xc1 is never used
+    REQUIRE(stream.next() == StreamDecoder::Error);
+    REQUIRE(stream.next() == StreamDecoder::Error);
+
+    stream.reset();
+    std::vector<uint8_t> uint64Chunk{{0xcf, 1, 2, 3, 4, 5, 6, 7}};
+    REQUIRE(stream.feed(uint64Chunk.data(), uint64Chunk.size()) == true);
+    REQUIRE(stream.next() == StreamDecoder::NeedMoreData);
+    uint8_t lastByte = 8;
+    REQUIRE(stream.feed(&lastByte, 1) == true);
+    REQUIRE(stream.next() == StreamDecoder::Element);
+    REQUIRE(stream.getElement().getUint64().get() == 0x0102030405060708);
+    REQUIRE(stream.isMessageComplete() == true);
+}
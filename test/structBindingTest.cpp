@@ -0,0 +1,163 @@
+// Copyright 2021 Rainer Schoenberger
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "StructBinding.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace ZCMessagePack;
+
+struct Position
+{
+    int32_t x = 0;
+    int32_t y = 0;
+};
+
+struct Sensor
+{
+    uint32_t id = 0;
+    char name[8] = "";
+    bool active = false;
+    double value = 0;
+    Position position;
+    std::string_view unit;
+};
+
+template<>
+struct ZCMessagePack::MessageFields<Position>
+{
+    static constexpr auto fields = std::make_tuple(
+            makeField("x", &Position::x),
+            makeField("y", &Position::y));
+};
+
+template<>
+struct ZCMessagePack::MessageFields<Sensor>
+{
+    static constexpr auto fields = std::make_tuple(
+            makeField("id", &Sensor::id),
+            makeField("name", &Sensor::name),
+            makeField("active", &Sensor::active),
+            makeField("value", &Sensor::value),
+            makeField("position", &Sensor::position),
+            makeField("unit", &Sensor::unit));
+};
+
+TEST_CASE( "StructBinding_RoundTrip", "" ) {
+    Sensor sensor;
+    sensor.id = 70000;
+    strcpy(sensor.name, "temp");
+    sensor.active = true;
+    sensor.value = 21.5;
+    sensor.position.x = -3;
+    sensor.position.y = 300;
+    sensor.unit = "degC";
+
+    uint8_t buffer[200];
+    Encoder encoder(buffer, sizeof(buffer));
+    REQUIRE(encodeFrom(encoder, sensor) == true);
+
+    Decoder decoder(buffer, encoder.getMessageSize());
+    REQUIRE(decoder.getMapSize().get() == 6);
+    REQUIRE(decoder["name"].compareString("temp").get() == true);
+    REQUIRE(decoder["position"]["y"].getInt16().get() == 300);
+
+    Sensor decoded;
+    auto missing = decodeInto(decoder, decoded);
+    REQUIRE(missing.isValid() == true);
+    REQUIRE(missing.get() == 0);
+    REQUIRE(decoded.id == 70000);
+    REQUIRE(std::string(decoded.name) == "temp");
+    REQUIRE(decoded.active == true);
+    REQUIRE(decoded.value == 21.5);
+    REQUIRE(decoded.position.x == -3);
+    REQUIRE(decoded.position.y == 300);
+    REQUIRE(decoded.unit == "degC");
+
+    // buffer too small
+    for(uint8_t size = 0; size < encoder.getMessageSize(); size++)
+    {
+        Encoder smallEncoder(buffer, size);
+        REQUIRE(encodeFrom(smallEncoder, sensor) == false);
+    }
+}
+
+TEST_CASE( "StructBinding_MissingFields", "" ) {
+    // {"value": "x", "extra": 1, "id": 5, "name": "too long name", "id": 6}
+    std::vector<uint8_t> message{{
+            0x85,
+            0xa5, 'v', 'a', 'l', 'u', 'e', 0xa1, 'x',
+            0xa5, 'e', 'x', 't', 'r', 'a', 0x01,
+            0xa2, 'i', 'd', 0x05,
+            0xa4, 'n', 'a', 'm', 'e', 0xad, 't', 'o', 'o', ' ', 'l', 'o', 'n', 'g', ' ', 'n', 'a', 'm', 'e',
+            0xa2, 'i', 'd', 0x06
+        }};
+    Decoder decoder(message.data(), message.size());
+
+    Sensor sensor;
+    auto missing = decodeInto(decoder, sensor);
+    REQUIRE(missing.isValid() == true);
+    // name (too long), active, value (type mismatch), position and unit
+    REQUIRE(missing.get() == 0b111110);
+    // first occurrence of duplicate keys is used
+    REQUIRE(sensor.id == 5);
+
+    // not a map
+    REQUIRE(decodeInto(decoder["id"], sensor).isValid() == false);
+
+    // malformed map
+    Decoder truncated(message.data(), message.size() - 1);
+    REQUIRE(decodeInto(truncated, sensor).isValid() == false);
+}
+
+TEST_CASE( "StructBinding_MismatchKeepsMember", "" ) {
+    // {"name": "too long name"}, {"name": 5}
+    std::vector<uint8_t> tooLong{{
+            0x81,
+            0xa4, 'n', 'a', 'm', 'e', 0xad, 't', 'o', 'o', ' ', 'l', 'o', 'n', 'g', ' ', 'n', 'a', 'm', 'e'
+        }};
+    std::vector<uint8_t> wrongType{{
+            0x81,
+            0xa4, 'n', 'a', 'm', 'e', 0x05
+        }};
+
+    Sensor sensor;
+    strcpy(sensor.name, "old");
+    REQUIRE(decodeInto(Decoder(tooLong.data(), tooLong.size()), sensor).get() == 0b111111);
+    REQUIRE(std::string(sensor.name) == "old");
+    REQUIRE(decodeInto(Decoder(wrongType.data(), wrongType.size()), sensor).get() == 0b111111);
+    REQUIRE(std::string(sensor.name) == "old");
+
+    // {"name": "new"}
+    std::vector<uint8_t> fits{{
+            0x81,
+            0xa4, 'n', 'a', 'm', 'e', 0xa3, 'n', 'e', 'w'
+        }};
+    REQUIRE(decodeInto(Decoder(fits.data(), fits.size()), sensor).get() == 0b111101);
+    REQUIRE(std::string(sensor.name) == "new");
+    // {"position": {"x": 7}}: nested struct misses "y"
+    std::vector<uint8_t> partial{{
+            0x81,
+            0xa8, 'p', 'o', 's', 'i', 't', 'i', 'o', 'n',
+            0x81, 0xa1, 'x', 0x07
+        }};
+    sensor.position.x = 1;
+    sensor.position.y = 2;
+    REQUIRE(decodeInto(Decoder(partial.data(), partial.size()), sensor).get() == 0b111111);
+    REQUIRE(sensor.position.x == 1);
+    REQUIRE(sensor.position.y == 2);
+}